@@ -0,0 +1,111 @@
+// Headless entry point: no window, no message pump
+// usage: restaurant_batch [--stream] [--vip-aging RULE] [--phase-profile FILE [--phase-sample N]]
+//                         [--memory-report] [--memory-samples FILE [--memory-interval N]]
+//                         <input file> <output file> [mode]
+//   --stream: read events while simulating (flat memory, sorted input only)
+//   --vip-aging: VIP priority gained per timestep waited, e.g. "0.5,10:2"
+//                (0.5 from the start, 2 after waiting 10 timesteps)
+//   --phase-profile: writes the time spent in each phase of the timestep
+//                (histograms, JSON) to FILE; builds with RESTAURANT_PHASE_TIMERS only
+//   --phase-sample: time one timestep in N (default 16; 1: all of them)
+//   --memory-report: live / peak bytes and allocations of orders, events, cooks,
+//                list nodes and GUI items after the statistics of the output file
+//   --memory-samples: the same counters as CSV, one row every N timesteps
+//                (--memory-interval, default 1000) to FILE
+//   mode: silent (default), step, interactive, demo  -- or 1..4 as in the GUI prompt
+#include "Rest/Restaurant.h"
+#include "Rest/ConsoleObserver.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+
+static bool ParseMode(const std::string& arg, PROG_MODE& mode)
+{
+	if (arg == "interactive" || arg == "1") mode = MODE_INTR;
+	else if (arg == "step" || arg == "2") mode = MODE_STEP;
+	else if (arg == "silent" || arg == "3") mode = MODE_SLNT;
+	else if (arg == "demo" || arg == "4") mode = MODE_DEMO;
+	else return false;
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	bool streaming = false;
+	bool agingOk = true;
+	VIPAging aging;
+	std::string profileFile;
+	int samplePeriod = PhaseProfile::DefaultSamplePeriod;
+	bool memoryReport = false;
+	std::string samplesFile;
+	int sampleInterval = 1000;
+	int first = 1;
+	while (first < argc && argv[first][0] == '-' && argv[first][1] == '-')
+	{
+		std::string opt = argv[first];
+		if (opt == "--stream") streaming = true;
+		else if (opt == "--vip-aging" && first + 1 < argc) agingOk = VIPAging::Parse(argv[++first], aging);
+		else if (opt == "--phase-profile" && first + 1 < argc) profileFile = argv[++first];
+		else if (opt == "--phase-sample" && first + 1 < argc) samplePeriod = atoi(argv[++first]);
+		else if (opt == "--memory-report") memoryReport = true;
+		else if (opt == "--memory-samples" && first + 1 < argc) samplesFile = argv[++first];
+		else if (opt == "--memory-interval" && first + 1 < argc) sampleInterval = atoi(argv[++first]);
+		else break;
+		first++;
+	}
+	int args = argc - first;
+
+	PROG_MODE mode = MODE_SLNT;
+	if (!agingOk || samplePeriod < 1 || sampleInterval < 1 || args < 2 || args > 3 || (args == 3 && !ParseMode(argv[first + 2], mode)))
+	{
+		std::cerr << "usage: " << argv[0] << " [--stream] [--vip-aging RULE] [--phase-profile FILE [--phase-sample N]]\n"
+			<< "       [--memory-report] [--memory-samples FILE [--memory-interval N]] <input file> <output file> [silent|step|interactive|demo]\n";
+		return 1;
+	}
+	if (!profileFile.empty() && !PhaseProfile::Enabled)
+	{
+		std::cerr << "--phase-profile: this build has no phase timers (configure with -DRESTAURANT_PHASE_TIMERS=ON)\n";
+		return 1;
+	}
+
+	// Silent runs report nothing, so the hot paths never build messages
+	ConsoleObserver console(mode == MODE_INTR);
+
+	Restaurant* pRest = new Restaurant;
+	if (mode != MODE_SLNT)
+		pRest->setObserver(&console);
+	pRest->setStreaming(streaming);
+	pRest->setVIPAging(aging);
+
+	PhaseProfile profile(samplePeriod);
+	if (!profileFile.empty())
+		pRest->setPhaseProfile(&profile);
+
+	pRest->setMemoryReport(memoryReport);
+	std::ofstream samples;
+	if (!samplesFile.empty())
+	{
+		samples.open(samplesFile);
+		if (!samples.is_open())
+		{
+			std::cerr << "ERROR: cannot write to " << samplesFile << "\n";
+			delete pRest;
+			return 2;
+		}
+		pRest->setMemorySamples(&samples, sampleInterval);
+	}
+
+	bool ok = pRest->RunBatch(argv[first], argv[first + 1], mode);
+	if (!ok)
+		std::cerr << "ERROR: " << pRest->getLastError() << "\n";
+	else if (!profileFile.empty() && !profile.writeJson(profileFile))
+	{
+		std::cerr << "ERROR: cannot write to " << profileFile << "\n";
+		ok = false;
+	}
+
+	delete pRest;
+
+	return ok ? 0 : 2;
+}
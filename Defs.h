@@ -41,7 +41,7 @@ enum COOK_TYPE
 };
 
 
-#define MaxPossibleOrdCnt 999	//max possible order count (arbitrary value)
+#define MaxPossibleOrdCnt 999	//max order items the GUI draws per timestep (order IDs are not limited by this)
 #define MaxPossibleMcCnt  100	//max possible cook count (arbitrary value)
 
 
@@ -11,14 +11,14 @@ ArrivalEvent::ArrivalEvent(int eTime, int oID, ORD_TYPE oType, int size, double
 void ArrivalEvent::Execute(Restaurant* pRest)
 {
     // Create Order ONCE (as required by project: "allocate once, move don’t copy")
-    Order* pOrder = new Order(OrderID, OrdType);
+    Order* pOrder = pRest->CreateOrder(OrderID, OrdType);
     pOrder->setArrTime(Time_Step);
     pOrder->setOrderSize(OrderSize);
     pOrder->setTotalMoney(OrdMoney);
 	if (OrdType == TYPE_VIP)
 	{
 	    // Calculate priority for VIP order
-	    int priority = (int)(pOrder->calculateVIPPriority());
+	    double priority = pOrder->calculateVIPPriority();
 	    pRest->AddVIPOrder(pOrder, priority);
 	}
 	else
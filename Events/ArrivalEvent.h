@@ -2,7 +2,7 @@
 #define __ARRIVAL_EVENT_H_
 
 #include "Event.h"
-#include "..\Rest\Order.h" 
+#include "../Rest/Order.h" 
 
 
 //class for the arrival event
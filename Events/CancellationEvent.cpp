@@ -1,5 +1,5 @@
 #include "CancellationEvent.h"
-#include "..\Rest\Restaurant.h"
+#include "../Rest/Restaurant.h"
 
 CancellationEvent::CancellationEvent(int eTime, int oID)
 	: Event(eTime, oID)
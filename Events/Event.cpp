@@ -1,4 +1,6 @@
  #include "Event.h"
+#include "../Generic_DS/AllocTracker.h"
+#include <new>
 
 
 Event::Event(int eTime, int ordID)
@@ -23,3 +25,15 @@ Event::~Event()
 
 }
 
+void* Event::operator new(size_t size)
+{
+	AllocTracker::onAlloc(ALLOC_EVENTS, size);
+	return ::operator new(size);
+}
+
+void Event::operator delete(void* p, size_t size)
+{
+	AllocTracker::onFree(ALLOC_EVENTS, size);
+	::operator delete(p);
+}
+
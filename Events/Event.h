@@ -1,7 +1,8 @@
 #ifndef __EVENT_H_
 #define __EVENT_H_
 
-#include "..\Defs.h"
+#include "../Defs.h"
+#include <cstddef>
 
 class Restaurant;	//Forward declation
 
@@ -18,6 +19,10 @@ public:
 	int getOrderID() const;
 	virtual ~Event();
 
+	// Counted as ALLOC_EVENTS (see AllocTracker)
+	static void* operator new(size_t size);
+	static void operator delete(void* p, size_t size);
+
 
 	virtual void Execute(Restaurant* pRest)=0;	////a pointer to "Restaurant" and events need it to execute
 
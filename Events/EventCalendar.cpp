@@ -0,0 +1,115 @@
+#include "EventCalendar.h"
+
+EventCalendar::EventCalendar()
+	: count(0), capacity(64), nextSeq(0)
+{
+	heap = new Entry[capacity];
+}
+
+EventCalendar::~EventCalendar()
+{
+	clear();
+	delete[] heap;
+}
+
+// Earlier time first, file order for equal times
+bool EventCalendar::earlier(const Entry& a, const Entry& b) const
+{
+	if (a.time != b.time)
+		return a.time < b.time;
+	return a.seq < b.seq;
+}
+
+void EventCalendar::resize()
+{
+	capacity *= 2;
+	Entry* newHeap = new Entry[capacity];
+	for (int i = 0; i < count; i++)
+		newHeap[i] = heap[i];
+	delete[] heap;
+	heap = newHeap;
+}
+
+void EventCalendar::siftUp(int index)
+{
+	Entry moving = heap[index];
+	while (index > 0)
+	{
+		int parent = (index - 1) / 2;
+		if (!earlier(moving, heap[parent]))
+			break;
+		heap[index] = heap[parent];
+		index = parent;
+	}
+	heap[index] = moving;
+}
+
+void EventCalendar::siftDown(int index)
+{
+	Entry moving = heap[index];
+	while (true)
+	{
+		int child = 2 * index + 1;
+		if (child >= count)
+			break;
+		if (child + 1 < count && earlier(heap[child + 1], heap[child]))
+			child++;
+		if (!earlier(heap[child], moving))
+			break;
+		heap[index] = heap[child];
+		index = child;
+	}
+	heap[index] = moving;
+}
+
+// Complexity: O(log E), O(1) when events arrive in non-decreasing time order
+void EventCalendar::insert(Event* pEvent)
+{
+	if (!pEvent) return;
+	if (count == capacity) resize();
+
+	heap[count].pEvent = pEvent;
+	heap[count].time = pEvent->getEventTime();
+	heap[count].seq = nextSeq++;
+	siftUp(count);
+	count++;
+}
+
+// Complexity: O(log E)
+bool EventCalendar::popDue(int currentTime, Event*& pEvent)
+{
+	if (count == 0 || heap[0].time > currentTime)
+		return false;
+
+	pEvent = heap[0].pEvent;
+	count--;
+	if (count > 0)
+	{
+		heap[0] = heap[count];
+		siftDown(0);
+	}
+	return true;
+}
+
+// Complexity: O(1)
+int EventCalendar::nextEventTime() const
+{
+	return (count > 0) ? heap[0].time : -1;
+}
+
+bool EventCalendar::isEmpty() const
+{
+	return count == 0;
+}
+
+int EventCalendar::getSize() const
+{
+	return count;
+}
+
+void EventCalendar::clear()
+{
+	for (int i = 0; i < count; i++)
+		delete heap[i].pEvent;
+	count = 0;
+}
@@ -0,0 +1,55 @@
+#ifndef __EVENT_CALENDAR_H_
+#define __EVENT_CALENDAR_H_
+
+#include "Event.h"
+
+// Time-ordered event calendar (binary min-heap keyed on Time_Step)
+// Events that share a timestep run in their insertion (file) order. This is
+// intended and differs from the old linear scan of the Events list, which
+// ran them in reverse file order (its InsertEnd prepended).
+//
+// Complexity:
+//   insert / popDue            -> O(log E)  (O(1) when the input is already sorted)
+//   nextEventTime / isEmpty    -> O(1)
+class EventCalendar
+{
+    struct Entry {
+        Event* pEvent;
+        int time;            // cached Time_Step of the event
+        long long seq;       // insertion order -> tie breaker for equal times
+    };
+
+    Entry* heap;
+    int count;
+    int capacity;
+    long long nextSeq;
+
+    bool earlier(const Entry& a, const Entry& b) const;
+    void resize();
+    void siftUp(int index);
+    void siftDown(int index);
+
+public:
+    EventCalendar();
+    ~EventCalendar();
+
+    // The calendar owns its events (we hold raw pointers)
+    EventCalendar(const EventCalendar&) = delete;
+    EventCalendar& operator=(const EventCalendar&) = delete;
+
+    void insert(Event* pEvent);
+
+    // Pops the earliest event if it is due (time <= currentTime)
+    // returns false when no event is due at this timestep
+    bool popDue(int currentTime, Event*& pEvent);
+
+    // Time of the earliest pending event (-1 if the calendar is empty)
+    int nextEventTime() const;
+
+    bool isEmpty() const;
+    int getSize() const;
+
+    void clear();    // deletes all pending events
+};
+
+#endif
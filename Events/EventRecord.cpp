@@ -0,0 +1,40 @@
+#include "EventRecord.h"
+#include "ArrivalEvent.h"
+#include "CancellationEvent.h"
+#include "PromotionEvent.h"
+
+Event* MakeEvent(const EventRecord& rec)
+{
+	switch (rec.kind)
+	{
+	case 'R': return new ArrivalEvent(rec.time, rec.orderID, rec.ordType, rec.size, rec.money);
+	case 'X': return new CancellationEvent(rec.time, rec.orderID);
+	case 'P': return new PromotionEvent(rec.time, rec.orderID, rec.extraMoney);
+	}
+	return nullptr;
+}
+
+void ExecuteEvent(const EventRecord& rec, Restaurant* pRest)
+{
+	switch (rec.kind)
+	{
+	case 'R':
+	{
+		ArrivalEvent e(rec.time, rec.orderID, rec.ordType, rec.size, rec.money);
+		e.Execute(pRest);
+		break;
+	}
+	case 'X':
+	{
+		CancellationEvent e(rec.time, rec.orderID);
+		e.Execute(pRest);
+		break;
+	}
+	case 'P':
+	{
+		PromotionEvent e(rec.time, rec.orderID, rec.extraMoney);
+		e.Execute(pRest);
+		break;
+	}
+	}
+}
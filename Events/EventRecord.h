@@ -0,0 +1,30 @@
+#ifndef __EVENT_RECORD_H_
+#define __EVENT_RECORD_H_
+
+#include "../Defs.h"
+
+class Event;
+class Restaurant;
+
+// Plain description of one input event line, before any Event object exists
+//   R <typ> <ts> <id> <size> <money>
+//   X <ts> <id>
+//   P <ts> <id> <extra money>
+struct EventRecord
+{
+	char kind;          // 'R' (arrival), 'X' (cancellation) or 'P' (promotion)
+	ORD_TYPE ordType;   // R only
+	int time;           // timestep of the event
+	int orderID;
+	int size;           // R only: number of dishes
+	double money;       // R only: order money
+	int extraMoney;     // P only
+};
+
+// Allocates the Event object that the record describes
+Event* MakeEvent(const EventRecord& rec);
+
+// Executes the record's event right away, without allocating it
+void ExecuteEvent(const EventRecord& rec, Restaurant* pRest);
+
+#endif
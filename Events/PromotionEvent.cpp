@@ -1,5 +1,5 @@
 #include "PromotionEvent.h"
-#include "..\Rest\Restaurant.h"
+#include "../Rest/Restaurant.h"
 
 PromotionEvent::PromotionEvent(int eTime, int ordID, int extraMoney)
     : Event(eTime, ordID), ExtraMoney(extraMoney)
@@ -223,7 +223,9 @@ void GUI::UpdateInterface()
 */
 void GUI::AddToDrawingList(Order* pOrd)
 {
-	
+	if (DrawingItemsCount >= maxItemCnt)
+		return;	//drawing list is full (regions can't show more anyway)
+
 	DrawingItem *pDitem=new DrawingItem;
 	pDitem->ID = pOrd->GetID();
 	pDitem->clr = DrawingColors[pOrd->GetType()];
@@ -251,7 +253,9 @@ void GUI::AddToDrawingList(Order* pOrd)
 
 void GUI::AddToDrawingList(Cook* pC)
 {
-	
+	if (DrawingItemsCount >= maxItemCnt)
+		return;
+
 	DrawingItem *pDitem=new DrawingItem;
 	pDitem->ID = pC->GetID();
 	pDitem->clr = DrawingColors[pC->GetType()];
@@ -1,20 +1,23 @@
 #ifndef __GUI_H_
 #define __GUI_H_
 
-#include "..\CMUgraphicsLib\CMUgraphics.h"
-#include "..\Defs.h"
+#include "../CMUgraphicsLib/CMUgraphics.h"
+#include "../Defs.h"
 
-#include "..\Rest\Order.h"
+#include "../Rest/Order.h"
 
-#include "..\Rest\Cook.h"
+#include "../Rest/Cook.h"
 
 
-#include "..\Generic_DS\Queue.h"
+#include "../Generic_DS/Queue.h"
+#include "../Generic_DS/AllocTracker.h"
+
+#include "../Rest/SimObserver.h"
 
 #include <string>
 using namespace std;
 
-class GUI
+class GUI : public SimObserver
 {
 	enum GUI_REGION {	
 		ORD_REG,	//GUI Regions where waiting orders are drawn
@@ -29,6 +32,16 @@ class GUI
 		int ID;		//ID to be printed on the screen indicating this item
 		GUI_REGION region;	//Region where it should be drawn
 		color	clr;	//drawing color
+
+		// Counted as ALLOC_GUI (see AllocTracker)
+		static void* operator new(size_t size) {
+			AllocTracker::onAlloc(ALLOC_GUI, size);
+			return ::operator new(size);
+		}
+		static void operator delete(void* p, size_t size) {
+			AllocTracker::onFree(ALLOC_GUI, size);
+			::operator delete(p);
+		}
 	};
 
 private:
@@ -0,0 +1,76 @@
+#ifndef __ALLOC_TRACKER_H_
+#define __ALLOC_TRACKER_H_
+
+#include <cstddef>
+
+// What an allocation belongs to
+enum ALLOC_TAG
+{
+	ALLOC_ORDERS,
+	ALLOC_EVENTS,
+	ALLOC_COOKS,
+	ALLOC_NODES,		// nodes of the linked containers
+	ALLOC_GUI,			// drawing items
+	ALLOC_TAG_CNT
+};
+
+struct AllocCounters
+{
+	long long liveBytes;
+	long long peakBytes;		// highest liveBytes so far
+	long long allocations;
+	long long frees;
+	long long allocatedBytes;	// over all allocations
+};
+
+/*
+Live / peak bytes and allocation counts per ALLOC_TAG.
+
+Counts objects, not the memory under them: an order created in an
+OrderPool slab or a node taken from a NodePool counts from creation to
+release, whatever the pool does with its blocks. Leaks (objects never
+released) and churn therefore show up even where the pools hide them
+from the heap.
+
+The counters belong to the calling thread: a restaurant runs on one thread
+(replications and sweeps run one per worker), so they cover the runs of
+that thread without any locking.
+Complexity: onAlloc / onFree -> O(1)
+*/
+class AllocTracker
+{
+	static inline thread_local AllocCounters counters[ALLOC_TAG_CNT] = {};
+
+public:
+	static void onAlloc(ALLOC_TAG tag, size_t bytes) {
+		AllocCounters& c = counters[tag];
+		c.liveBytes += (long long)bytes;
+		if (c.liveBytes > c.peakBytes)
+			c.peakBytes = c.liveBytes;
+		c.allocations++;
+		c.allocatedBytes += (long long)bytes;
+	}
+
+	// count objects of `bytes` each (freed in bulk, e.g. with their pool)
+	static void onFree(ALLOC_TAG tag, size_t bytes, long long count = 1) {
+		AllocCounters& c = counters[tag];
+		c.liveBytes -= (long long)bytes * count;
+		c.frees += count;
+	}
+
+	static const AllocCounters& get(ALLOC_TAG tag) { return counters[tag]; }
+
+	// Zeroes the counters of this thread (objects alive now are then
+	// freed "below zero": reset between runs, not during one)
+	static void reset() {
+		for (int t = 0; t < ALLOC_TAG_CNT; t++)
+			counters[t] = AllocCounters();
+	}
+
+	static const char* TagName(ALLOC_TAG tag) {
+		static const char* const Names[ALLOC_TAG_CNT] = { "Orders", "Events", "Cooks", "Nodes", "GUI" };
+		return Names[tag];
+	}
+};
+
+#endif
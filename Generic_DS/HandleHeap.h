@@ -0,0 +1,307 @@
+#ifndef __HANDLE_HEAP_H_
+#define __HANDLE_HEAP_H_
+
+#include <utility>
+
+/*
+Array-based d-ary MIN heap (Arity children per node) whose entries can be
+re-keyed or removed from the middle.
+
+push() returns a handle (small int) that stays valid until the entry is
+popped or erased, so the owner of an item can change its key or remove it
+later without searching the heap. Entries with equal keys come out in
+insertion order. K only needs operator<.
+
+A wider heap is shallower (log_d n levels) and a node's children share a
+cache line or two, at the cost of d - 1 comparisons per level on the way
+down; 4 is a good choice for queues that are popped a lot.
+
+Complexity:
+	push / pop / erase / update	-> O(log n)
+	build						-> O(n)
+	peek / isEmpty / getKey		-> O(1)
+*/
+
+template <typename T, typename K = int, int Arity = 2>
+class HandleHeap
+{
+	static_assert(Arity >= 2, "a heap needs at least two children per node");
+
+	struct Entry {
+		T item;
+		K key;
+		long long seq;	// insertion order -> tie breaker for equal keys
+		int handle;
+	};
+
+	Entry* heap;
+	int count;
+	int capacity;
+
+	int* position;		// position[handle] = index in heap (-1 if free)
+	int* freeHandles;	// stack of recycled handles
+	int freeCount;
+	int handleCapacity;
+	int nextHandle;
+
+	long long nextSeq;
+
+	bool less(const Entry& a, const Entry& b) const {
+		if (a.key < b.key) return true;
+		if (b.key < a.key) return false;
+		return a.seq < b.seq;
+	}
+
+	void place(int index, Entry& e) {
+		heap[index] = std::move(e);
+		position[heap[index].handle] = index;
+	}
+
+	void reserve(int needed) {
+		if (needed <= capacity) return;
+		while (capacity < needed)
+			capacity *= 2;
+		Entry* newHeap = new Entry[capacity];
+		for (int i = 0; i < count; i++)
+			newHeap[i] = std::move(heap[i]);
+		delete[] heap;
+		heap = newHeap;
+	}
+
+	void resizeHandles() {
+		int newCapacity = handleCapacity * 2;
+		int* newPosition = new int[newCapacity];
+		int* newFree = new int[newCapacity];
+		for (int i = 0; i < handleCapacity; i++) {
+			newPosition[i] = position[i];
+			newFree[i] = freeHandles[i];
+		}
+		for (int i = handleCapacity; i < newCapacity; i++)
+			newPosition[i] = -1;
+		delete[] position;
+		delete[] freeHandles;
+		position = newPosition;
+		freeHandles = newFree;
+		handleCapacity = newCapacity;
+	}
+
+	int allocHandle() {
+		if (freeCount > 0)
+			return freeHandles[--freeCount];
+		if (nextHandle == handleCapacity)
+			resizeHandles();
+		return nextHandle++;
+	}
+
+	void releaseHandle(int handle) {
+		position[handle] = -1;
+		freeHandles[freeCount++] = handle;
+	}
+
+	void siftUp(int index) {
+		Entry moving = std::move(heap[index]);
+		while (index > 0) {
+			int parent = (index - 1) / Arity;
+			if (!less(moving, heap[parent]))
+				break;
+			place(index, heap[parent]);
+			index = parent;
+		}
+		place(index, moving);
+	}
+
+	void siftDown(int index) {
+		Entry moving = std::move(heap[index]);
+		while (true) {
+			int first = Arity * index + 1;
+			if (first >= count)
+				break;
+			int last = (first + Arity < count) ? first + Arity : count;
+			int child = first;
+			for (int c = first + 1; c < last; c++)
+				if (less(heap[c], heap[child]))
+					child = c;
+			if (!less(heap[child], moving))
+				break;
+			place(index, heap[child]);
+			index = child;
+		}
+		place(index, moving);
+	}
+
+	// Moves the entry at index up or down to its place
+	void restore(int index) {
+		if (index > 0 && less(heap[index], heap[(index - 1) / Arity]))
+			siftUp(index);
+		else
+			siftDown(index);
+	}
+
+	// Removes the entry at index and restores the heap property
+	void removeAt(int index) {
+		releaseHandle(heap[index].handle);
+		count--;
+		if (index == count)
+			return;
+		place(index, heap[count]);
+		restore(index);
+	}
+
+	void destroy() {
+		delete[] heap;
+		delete[] position;
+		delete[] freeHandles;
+	}
+
+	void stealFrom(HandleHeap& other) {
+		heap = other.heap;
+		count = other.count;
+		capacity = other.capacity;
+		position = other.position;
+		freeHandles = other.freeHandles;
+		freeCount = other.freeCount;
+		handleCapacity = other.handleCapacity;
+		nextHandle = other.nextHandle;
+		nextSeq = other.nextSeq;
+		other.heap = nullptr;
+		other.position = nullptr;
+		other.freeHandles = nullptr;
+		other.count = other.capacity = 0;
+		other.freeCount = other.handleCapacity = other.nextHandle = 0;
+	}
+
+public:
+	HandleHeap() {
+		capacity = 20;
+		count = 0;
+		heap = new Entry[capacity];
+
+		handleCapacity = 20;
+		position = new int[handleCapacity];
+		freeHandles = new int[handleCapacity];
+		for (int i = 0; i < handleCapacity; i++)
+			position[i] = -1;
+		freeCount = 0;
+		nextHandle = 0;
+		nextSeq = 0;
+	}
+
+	~HandleHeap() {
+		destroy();
+	}
+
+	HandleHeap(const HandleHeap&) = delete;
+	HandleHeap& operator=(const HandleHeap&) = delete;
+
+	// A moved-from heap may only be destroyed or assigned to
+	HandleHeap(HandleHeap&& other) noexcept {
+		stealFrom(other);
+	}
+
+	HandleHeap& operator=(HandleHeap&& other) noexcept {
+		if (this != &other) {
+			destroy();
+			stealFrom(other);
+		}
+		return *this;
+	}
+
+	bool isEmpty() const { return count == 0; }
+	int getSize() const { return count; }
+
+	// Returns the handle of the new entry
+	int push(const T& item, const K& key) {
+		if (count == capacity)
+			reserve(count + 1);
+		int handle = allocHandle();
+		heap[count].item = item;
+		heap[count].key = key;
+		heap[count].seq = nextSeq++;
+		heap[count].handle = handle;
+		position[handle] = count;
+		count++;
+		siftUp(count - 1);
+		return handle;
+	}
+
+	// Adds n entries at once (Floyd's bottom-up heap construction), in the
+	// insertion order of items; handles[i] (if given) gets the handle of items[i]
+	void build(const T* items, const K* keys, int n, int* handles = nullptr) {
+		if (n <= 0) return;
+		reserve(count + n);
+		for (int i = 0; i < n; i++) {
+			int handle = allocHandle();
+			heap[count].item = items[i];
+			heap[count].key = keys[i];
+			heap[count].seq = nextSeq++;
+			heap[count].handle = handle;
+			position[handle] = count;
+			count++;
+			if (handles)
+				handles[i] = handle;
+		}
+		for (int i = (count - 2) / Arity; i >= 0; i--)
+			siftDown(i);
+	}
+
+	bool peek(T& item, K& key) const {
+		if (isEmpty()) return false;
+		item = heap[0].item;
+		key = heap[0].key;
+		return true;
+	}
+
+	bool pop(T& item, K& key) {
+		if (isEmpty()) return false;
+		item = heap[0].item;
+		key = heap[0].key;
+		removeAt(0);
+		return true;
+	}
+
+	// Removes the entry with this handle (false if it is no longer in the heap)
+	bool erase(int handle) {
+		if (!contains(handle))
+			return false;
+		removeAt(position[handle]);
+		return true;
+	}
+
+	// Changes the key of the entry with this handle (it keeps its place
+	// among equal keys); false if it is no longer in the heap
+	bool update(int handle, const K& key) {
+		if (!contains(handle))
+			return false;
+		int index = position[handle];
+		heap[index].key = key;
+		restore(index);
+		return true;
+	}
+
+	bool contains(int handle) const {
+		return handle >= 0 && handle < nextHandle && position[handle] >= 0;
+	}
+
+	// Key of the entry with this handle (false if it is no longer in the heap)
+	bool getKey(int handle, K& key) const {
+		if (!contains(handle)) return false;
+		key = heap[position[handle]].key;
+		return true;
+	}
+
+	// Helper for traversal in heap order (e.g. for GUI iteration)
+	bool getItem(int i, T& result) const {
+		if (i < 0 || i >= count) return false;
+		result = heap[i].item;
+		return true;
+	}
+
+	bool getEntry(int i, T& item, K& key) const {
+		if (i < 0 || i >= count) return false;
+		item = heap[i].item;
+		key = heap[i].key;
+		return true;
+	}
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef __NODE_POOL_H_
+#define __NODE_POOL_H_
+
+#include <new>
+#include "Node.h"
+#include "AllocTracker.h"
+
+/*
+Node allocators for the linked containers (LinkedList, LinkedQueue, Queue),
+given as their second template parameter:
+
+	HeapNodeAllocator<T>	one new / delete per node (the default)
+	NodePool<T>				per-container free list over blocks of nodes
+
+Both count their nodes as ALLOC_NODES (see AllocTracker).
+
+A NodePool belongs to one container. Freed nodes go on its free list and
+are handed out again first, so a container whose size stays bounded stops
+calling the global allocator once it reached its largest size. The blocks
+are returned when the container is destroyed.
+
+Complexity:
+	allocate / deallocate	-> O(1) (one block allocation per BlockSize nodes)
+*/
+
+template <typename T>
+struct HeapNodeAllocator
+{
+	Node<T>* allocate(const T& item) {
+		AllocTracker::onAlloc(ALLOC_NODES, sizeof(Node<T>));
+		return new Node<T>(item);
+	}
+
+	void deallocate(Node<T>* node) {
+		AllocTracker::onFree(ALLOC_NODES, sizeof(Node<T>));
+		delete node;
+	}
+};
+
+template <typename T>
+class NodePool
+{
+	static const int BlockSize = 256;
+
+	union Slot {
+		Slot* nextFree;
+		alignas(Node<T>) unsigned char storage[sizeof(Node<T>)];
+	};
+
+	struct Block {
+		Slot slots[BlockSize];
+		Block* next;
+	};
+
+	Block* blocks;		// every block, newest first
+	int usedInFirst;	// slots of blocks handed out so far
+	Slot* freeList;
+
+	void release() {
+		while (blocks) {
+			Block* next = blocks->next;
+			delete blocks;
+			blocks = next;
+		}
+	}
+
+public:
+	NodePool() : blocks(nullptr), usedInFirst(BlockSize), freeList(nullptr) {}
+
+	// Nodes still allocated are released with the blocks, without running
+	// their destructors (the containers destroy their nodes first)
+	~NodePool() { release(); }
+
+	NodePool(const NodePool&) = delete;
+	NodePool& operator=(const NodePool&) = delete;
+
+	// Moving a container moves its nodes, so the blocks go along
+	NodePool(NodePool&& other) noexcept
+		: blocks(other.blocks), usedInFirst(other.usedInFirst), freeList(other.freeList)
+	{
+		other.blocks = nullptr;
+		other.usedInFirst = BlockSize;
+		other.freeList = nullptr;
+	}
+
+	NodePool& operator=(NodePool&& other) noexcept {
+		if (this != &other) {
+			release();
+			blocks = other.blocks;
+			usedInFirst = other.usedInFirst;
+			freeList = other.freeList;
+			other.blocks = nullptr;
+			other.usedInFirst = BlockSize;
+			other.freeList = nullptr;
+		}
+		return *this;
+	}
+
+	Node<T>* allocate(const T& item) {
+		Slot* slot;
+		if (freeList) {
+			slot = freeList;
+			freeList = slot->nextFree;
+		}
+		else {
+			if (usedInFirst == BlockSize) {
+				Block* block = new Block;
+				block->next = blocks;
+				blocks = block;
+				usedInFirst = 0;
+			}
+			slot = &blocks->slots[usedInFirst++];
+		}
+		AllocTracker::onAlloc(ALLOC_NODES, sizeof(Node<T>));
+		return new (slot->storage) Node<T>(item);
+	}
+
+	void deallocate(Node<T>* node) {
+		AllocTracker::onFree(ALLOC_NODES, sizeof(Node<T>));
+		node->~Node<T>();
+		Slot* slot = reinterpret_cast<Slot*>(node);
+		slot->nextFree = freeList;
+		freeList = slot;
+	}
+};
+
+#endif
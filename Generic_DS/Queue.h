@@ -43,14 +43,17 @@ Single Node Case:
 */
 
 #include "Node.h"
+#include "NodePool.h"
 
-template <typename T>
+// Alloc: where the nodes come from (see NodePool.h)
+template <typename T, typename Alloc = HeapNodeAllocator<T>>
 class Queue
 {
 private :
 	
 	Node<T>* backPtr;
 	Node<T>* frontPtr;
+	Alloc nodes;
 public :
 	Queue();	
 	bool isEmpty() const ;
@@ -68,8 +71,8 @@ The constructor of the Queue class.
 
 */
 
-template <typename T>
-Queue<T>::Queue()
+template <typename T, typename Alloc>
+Queue<T, Alloc>::Queue()
 {
 	backPtr=nullptr;
 	frontPtr=nullptr;
@@ -84,8 +87,8 @@ Sees whether this queue is empty.
 Input: None.
 Output: True if the queue is empty; otherwise false.
 */
-template <typename T>
-bool Queue<T>::isEmpty() const
+template <typename T, typename Alloc>
+bool Queue<T, Alloc>::isEmpty() const
 {
 	if(frontPtr==nullptr)
 		return true;
@@ -102,10 +105,10 @@ Input: newEntry .
 Output: True if the operation is successful; otherwise false.
 */
 
-template <typename T>
-bool Queue<T>::enqueue( const T& newEntry)
+template <typename T, typename Alloc>
+bool Queue<T, Alloc>::enqueue( const T& newEntry)
 {
-	Node<T>* newNodePtr = new Node<T>(newEntry);
+	Node<T>* newNodePtr = nodes.allocate(newEntry);
 	// Insert the new node
 	if (isEmpty())
 		frontPtr = newNodePtr; // The queue is empty
@@ -126,8 +129,8 @@ Input: None.
 Output: True if the operation is successful; otherwise false.
 */
 
-template <typename T>
-bool Queue<T>:: dequeue(T& frntEntry)  
+template <typename T, typename Alloc>
+bool Queue<T, Alloc>:: dequeue(T& frntEntry)  
 {
 	if(isEmpty())
 		return false;
@@ -140,7 +143,7 @@ bool Queue<T>:: dequeue(T& frntEntry)
 		backPtr = nullptr ;	
 		
 	// Free memory reserved by the dequeued node
-	delete nodeToDeletePtr;
+	nodes.deallocate(nodeToDeletePtr);
 
 
 	return true;
@@ -157,8 +160,8 @@ Input: None.
 Output: The front of the queue.
 return: flase if Queue is empty
 */
-template <typename T>
-bool Queue<T>:: peekFront(T& frntEntry) const 
+template <typename T, typename Alloc>
+bool Queue<T, Alloc>:: peekFront(T& frntEntry) const 
 {
 	if(isEmpty())
 		return false;
@@ -169,9 +172,11 @@ bool Queue<T>:: peekFront(T& frntEntry) const
 }
 ///////////////////////////////////////////////////////////////////////////////////
 
-template <typename T>
-Queue<T>::~Queue()
+template <typename T, typename Alloc>
+Queue<T, Alloc>::~Queue()
 {
+	T item;
+	while (dequeue(item));
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -183,8 +188,8 @@ Output: count: the length of the returned array (zero if Queue is empty)
 returns: The array of T. (nullptr if Queue is empty)
 */
 
-template <typename T>
-T* Queue<T>::toArray(int& count)
+template <typename T, typename Alloc>
+T* Queue<T, Alloc>::toArray(int& count)
 {
 	count=0;
 
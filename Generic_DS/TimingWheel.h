@@ -0,0 +1,209 @@
+#ifndef __TIMING_WHEEL_H_
+#define __TIMING_WHEEL_H_
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/*
+Hashed timing wheel: items that fire at a given timestep.
+
+An item scheduled for time t goes in slot t mod SlotCount (a power of two
+larger than the horizon), in a doubly linked list threaded through one
+entry array, so schedule and cancel are O(1) and advancing the clock only
+visits the slots of the timesteps it passes. A bitset of non-empty slots
+finds the next firing time without walking empty slots one by one.
+
+schedule() returns a handle that stays valid until the item fires or is
+cancelled. Fire times must lie within horizon timesteps of the time the
+item is scheduled at, and after the current clock.
+
+Complexity:
+	schedule / cancel	-> O(1)
+	advanceTo			-> O(slots passed + items fired)
+	nextFireTime		-> O(SlotCount / 64) worst case
+*/
+
+template <typename T>
+class TimingWheel
+{
+	struct Entry {
+		T item;
+		int fireTime;
+		int prev, next;		// entry indices in the slot list (-1 = none)
+	};
+
+	Entry* entries;
+	int entryCapacity;
+	int nextUnused;
+	int freeHead;			// recycled entries, chained through next
+
+	int* slotHead;
+	int* slotTail;
+	unsigned long long* nonEmpty;	// bit s -> slot s has items
+	int slotCount;			// power of two
+	int mask;
+
+	int now;				// last timestep advanced to
+	int count;
+
+	static int lowestSetBit(unsigned long long word) {
+#ifdef _MSC_VER
+		unsigned long index;
+		if (_BitScanForward(&index, (unsigned long)(word & 0xFFFFFFFFull)))
+			return (int)index;
+		_BitScanForward(&index, (unsigned long)(word >> 32));
+		return (int)index + 32;
+#else
+		return __builtin_ctzll(word);
+#endif
+	}
+
+	void unlink(int e) {
+		int slot = entries[e].fireTime & mask;
+		if (entries[e].prev >= 0) entries[entries[e].prev].next = entries[e].next;
+		else slotHead[slot] = entries[e].next;
+		if (entries[e].next >= 0) entries[entries[e].next].prev = entries[e].prev;
+		else slotTail[slot] = entries[e].prev;
+		if (slotHead[slot] < 0)
+			nonEmpty[slot >> 6] &= ~(1ull << (slot & 63));
+
+		entries[e].prev = -2;		// marks a free entry
+		entries[e].next = freeHead;
+		freeHead = e;
+		count--;
+	}
+
+	int allocEntry() {
+		if (freeHead >= 0) {
+			int e = freeHead;
+			freeHead = entries[e].next;
+			return e;
+		}
+		if (nextUnused == entryCapacity) {
+			int newCapacity = entryCapacity * 2;
+			Entry* newEntries = new Entry[newCapacity];
+			for (int i = 0; i < entryCapacity; i++)
+				newEntries[i] = entries[i];
+			delete[] entries;
+			entries = newEntries;
+			entryCapacity = newCapacity;
+		}
+		return nextUnused++;
+	}
+
+	void release() {
+		delete[] entries;
+		delete[] slotHead;
+		delete[] slotTail;
+		delete[] nonEmpty;
+	}
+
+public:
+	TimingWheel() : entries(nullptr), slotHead(nullptr), slotTail(nullptr), nonEmpty(nullptr) {
+		reset(64);
+	}
+
+	~TimingWheel() {
+		release();
+	}
+
+	TimingWheel(const TimingWheel&) = delete;
+	TimingWheel& operator=(const TimingWheel&) = delete;
+
+	// Empties the wheel, sized for fire times up to horizon timesteps ahead
+	void reset(int horizon) {
+		release();
+
+		slotCount = 64;
+		while (slotCount <= horizon)
+			slotCount *= 2;
+		mask = slotCount - 1;
+		slotHead = new int[slotCount];
+		slotTail = new int[slotCount];
+		for (int s = 0; s < slotCount; s++)
+			slotHead[s] = slotTail[s] = -1;
+		nonEmpty = new unsigned long long[slotCount / 64];
+		for (int w = 0; w < slotCount / 64; w++)
+			nonEmpty[w] = 0;
+
+		entryCapacity = 64;
+		entries = new Entry[entryCapacity];
+		nextUnused = 0;
+		freeHead = -1;
+		now = 0;
+		count = 0;
+	}
+
+	bool isEmpty() const { return count == 0; }
+	int getSize() const { return count; }
+
+	// Returns the handle of the new timer
+	int schedule(const T& item, int fireTime) {
+		int e = allocEntry();
+		int slot = fireTime & mask;
+		entries[e].item = item;
+		entries[e].fireTime = fireTime;
+		entries[e].prev = slotTail[slot];
+		entries[e].next = -1;
+		if (slotTail[slot] >= 0) entries[slotTail[slot]].next = e;
+		else slotHead[slot] = e;
+		slotTail[slot] = e;
+		nonEmpty[slot >> 6] |= 1ull << (slot & 63);
+		count++;
+		return e;
+	}
+
+	// False if the timer already fired or was cancelled
+	bool cancel(int handle) {
+		if (handle < 0 || handle >= nextUnused || entries[handle].prev == -2)
+			return false;
+		unlink(handle);
+		return true;
+	}
+
+	// Moves the clock to currentTime and calls fire(item) for every item due
+	// by then, earliest first (same time: in schedule order)
+	template <typename F>
+	void advanceTo(int currentTime, F fire) {
+		if (currentTime <= now) return;
+		int from = now + 1;
+		if (currentTime - now > slotCount)
+			from = currentTime - slotCount + 1;		// every slot once
+		now = currentTime;
+
+		for (int t = from; t <= currentTime && count > 0; t++) {
+			int e = slotHead[t & mask];
+			while (e >= 0) {
+				int next = entries[e].next;
+				if (entries[e].fireTime <= currentTime) {
+					T item = entries[e].item;
+					unlink(e);
+					fire(item);
+				}
+				e = next;
+			}
+		}
+	}
+
+	// Earliest fire time after the clock (-1 if none); exact when every
+	// timer was scheduled no earlier than the current clock
+	int nextFireTime() const {
+		if (count == 0) return -1;
+		int start = (now + 1) & mask;
+		int words = slotCount / 64;
+		int w = start >> 6;
+		unsigned long long bits = nonEmpty[w] & (~0ull << (start & 63));
+		for (int i = 0; i <= words; i++) {
+			if (bits) {
+				int slot = (w << 6) + lowestSetBit(bits);
+				return now + 1 + ((slot - start) & mask);
+			}
+			w = (w + 1) % words;
+			bits = nonEmpty[w];
+		}
+		return -1;
+	}
+};
+
+#endif
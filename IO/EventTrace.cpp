@@ -0,0 +1,202 @@
+#include "EventTrace.h"
+#include <algorithm>
+#include <cstring>
+
+static bool EarlierTime(const RTraceRecord& a, const RTraceRecord& b)
+{
+	return a.time < b.time;
+}
+
+EventTrace::EventTrace()
+	: count(0), times(nullptr), kinds(nullptr),
+	  arrivalCount(0), arrivalID(nullptr), arrivalSize(nullptr), arrivalMoney(nullptr), arrivalType(nullptr),
+	  cancellationCount(0), cancellationID(nullptr),
+	  promotionCount(0), promotionID(nullptr), promotionExtra(nullptr)
+{
+	memset(&header, 0, sizeof(header));
+}
+
+EventTrace::~EventTrace()
+{
+	reset();
+}
+
+void EventTrace::reset()
+{
+	delete[] times;
+	delete[] kinds;
+	delete[] arrivalID;
+	delete[] arrivalSize;
+	delete[] arrivalMoney;
+	delete[] arrivalType;
+	delete[] cancellationID;
+	delete[] promotionID;
+	delete[] promotionExtra;
+	times = nullptr;
+	kinds = nullptr;
+	arrivalID = arrivalSize = nullptr;
+	arrivalMoney = nullptr;
+	arrivalType = nullptr;
+	cancellationID = nullptr;
+	promotionID = promotionExtra = nullptr;
+	count = arrivalCount = cancellationCount = promotionCount = 0;
+}
+
+// Parses a text input into a new[] array of records
+bool EventTrace::loadText(const std::string& filename, RTraceRecord*& records, int& n)
+{
+	TraceParser parser;
+	if (!parser.open(filename) || !parser.readHeader(header))
+	{
+		error = parser.getError();
+		return false;
+	}
+
+	int capacity = (header.M > 0) ? header.M : 16;
+	records = new RTraceRecord[capacity];
+	n = 0;
+	EventRecord rec;
+	while (parser.next(rec))
+	{
+		if (n == capacity)	// more lines than declared: only if M was 0
+		{
+			RTraceRecord* bigger = new RTraceRecord[capacity * 2];
+			memcpy(bigger, records, sizeof(RTraceRecord) * n);
+			delete[] records;
+			records = bigger;
+			capacity *= 2;
+		}
+		ToRTraceRecord(rec, records[n++]);
+	}
+	if (parser.hasError())
+	{
+		error = parser.getError();
+		delete[] records;
+		records = nullptr;
+		return false;
+	}
+	return true;
+}
+
+bool EventTrace::load(const std::string& filename)
+{
+	reset();
+	error.clear();
+
+	RTraceFile mapped;
+	RTraceRecord* owned = nullptr;
+	const RTraceRecord* records;
+	int n;
+
+	if (RTraceFile::isRTrace(filename))
+	{
+		if (!mapped.open(filename))
+		{
+			error = mapped.getError();
+			return false;
+		}
+		header = mapped.getHeader();
+		records = mapped.begin();
+		n = (int)mapped.getCount();
+	}
+	else
+	{
+		if (!loadText(filename, owned, n))
+			return false;
+		records = owned;
+	}
+
+	bool sorted = true;
+	for (int i = 1; i < n && sorted; i++)
+		sorted = records[i - 1].time <= records[i].time;
+	if (!sorted)
+	{
+		if (!owned)
+		{
+			owned = new RTraceRecord[n];
+			memcpy(owned, records, sizeof(RTraceRecord) * n);
+		}
+		std::stable_sort(owned, owned + n, EarlierTime);
+		records = owned;
+	}
+
+	build(records, n);
+	delete[] owned;
+	return true;
+}
+
+// Splits sorted records into the per-kind arrays
+void EventTrace::build(const RTraceRecord* records, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		switch (records[i].kind)
+		{
+		case 'R': arrivalCount++; break;
+		case 'X': cancellationCount++; break;
+		case 'P': promotionCount++; break;
+		}
+	}
+
+	count = n;
+	times = new int[n];
+	kinds = new char[n];
+	arrivalID = new int[arrivalCount];
+	arrivalSize = new int[arrivalCount];
+	arrivalMoney = new double[arrivalCount];
+	arrivalType = new uint8_t[arrivalCount];
+	cancellationID = new int[cancellationCount];
+	promotionID = new int[promotionCount];
+	promotionExtra = new int[promotionCount];
+
+	int a = 0, x = 0, p = 0;
+	for (int i = 0; i < n; i++)
+	{
+		const RTraceRecord& r = records[i];
+		times[i] = r.time;
+		kinds[i] = (char)r.kind;
+		switch (r.kind)
+		{
+		case 'R':
+			arrivalID[a] = r.orderID;
+			arrivalSize[a] = r.size;
+			arrivalMoney[a] = r.money;
+			arrivalType[a] = r.ordType;
+			a++;
+			break;
+		case 'X':
+			cancellationID[x++] = r.orderID;
+			break;
+		case 'P':
+			promotionID[p] = r.orderID;
+			promotionExtra[p] = r.extraMoney;
+			p++;
+			break;
+		}
+	}
+}
+
+void EventTrace::take(Cursor& c, EventRecord& rec) const
+{
+	int i = c.next++;
+	rec.kind = kinds[i];
+	rec.time = times[i];
+	switch (rec.kind)
+	{
+	case 'R':
+		rec.orderID = arrivalID[c.arrival];
+		rec.size = arrivalSize[c.arrival];
+		rec.money = arrivalMoney[c.arrival];
+		rec.ordType = (ORD_TYPE)arrivalType[c.arrival];
+		c.arrival++;
+		break;
+	case 'X':
+		rec.orderID = cancellationID[c.cancellation++];
+		break;
+	case 'P':
+		rec.orderID = promotionID[c.promotion];
+		rec.extraMoney = promotionExtra[c.promotion];
+		c.promotion++;
+		break;
+	}
+}
@@ -0,0 +1,92 @@
+#ifndef __EVENT_TRACE_H_
+#define __EVENT_TRACE_H_
+
+#include <string>
+#include <cstdint>
+#include "TraceParser.h"
+#include "RTrace.h"
+
+/*
+Read-only event list of one input file, loaded once and replayed by any
+number of Restaurant instances (sweeps, replications), also from several
+threads at once: nothing in it changes after load(). Each replay keeps its
+own Cursor.
+
+Events are stored by kind in parallel arrays (structure of arrays). The
+replay order is kept in times[] / kinds[], one entry per event: sorted by
+timestep, equal timesteps in file order (the order the event calendar
+runs them). The n-th event of a kind reads the n-th entry of that kind's
+arrays.
+
+Memory: 22 bytes per arrival, 9 per cancellation, 13 per promotion.
+*/
+class EventTrace
+{
+public:
+	// Replay position (one per Restaurant)
+	struct Cursor {
+		int next;			// index into times[] / kinds[]
+		int arrival;		// next entry of the arrival arrays
+		int cancellation;
+		int promotion;
+	};
+
+private:
+	TraceHeader header;
+	int count;
+
+	// Replay order, all events
+	int* times;
+	char* kinds;			// 'R', 'X' or 'P'
+
+	// Arrivals
+	int arrivalCount;
+	int* arrivalID;
+	int* arrivalSize;
+	double* arrivalMoney;
+	uint8_t* arrivalType;	// ORD_TYPE
+
+	// Cancellations
+	int cancellationCount;
+	int* cancellationID;
+
+	// Promotions
+	int promotionCount;
+	int* promotionID;
+	int* promotionExtra;
+
+	std::string error;
+
+	void reset();
+	void build(const RTraceRecord* records, int n);
+	bool loadText(const std::string& filename, RTraceRecord*& records, int& n);
+
+public:
+	EventTrace();
+	~EventTrace();
+
+	EventTrace(const EventTrace&) = delete;
+	EventTrace& operator=(const EventTrace&) = delete;
+
+	// Text or .rtrace input; unsorted events are sorted (stable by timestep)
+	bool load(const std::string& filename);
+
+	const TraceHeader& getHeader() const { return header; }
+	int getCount() const { return count; }
+	int getArrivalCount() const { return arrivalCount; }
+	const std::string& getError() const { return error; }
+
+	static Cursor Start() { Cursor c = { 0, 0, 0, 0 }; return c; }
+
+	// Timestep of the event at the cursor (-1 when all were replayed)
+	int nextTime(const Cursor& c) const
+	{
+		return (c.next < count) ? times[c.next] : -1;
+	}
+
+	// Record of the event at the cursor, then moves past it
+	// (call only while nextTime(c) >= 0)
+	void take(Cursor& c, EventRecord& rec) const;
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Mapping zero bytes is not allowed: an empty file gets this sentinel as its
+// data (size 0, never unmapped), so open files always have non-null data
+static const char EmptyFile[1] = { 0 };
+
+MappedFile::MappedFile()
+	: data(nullptr), size(0)
+#ifdef _WIN32
+	, hFile(nullptr), hMapping(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& filename)
+{
+	close();
+
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	if (fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		data = EmptyFile;
+		size = 0;
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	hFile = file;
+	hMapping = mapping;
+	data = (const char*)view;
+	size = (size_t)fileSize.QuadPart;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (hMapping)
+	{
+		UnmapViewOfFile(data);
+		CloseHandle((HANDLE)hMapping);
+		CloseHandle((HANDLE)hFile);
+	}
+	hFile = nullptr;
+	hMapping = nullptr;
+	data = nullptr;
+	size = 0;
+}
+
+// Windows cannot unmap part of a view; the working set trimmer drops the
+// clean file pages on its own
+void MappedFile::release(size_t)
+{
+}
+
+#else
+
+bool MappedFile::open(const std::string& filename)
+{
+	close();
+
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	if (st.st_size == 0)
+	{
+		::close(fd);
+		data = EmptyFile;
+		size = 0;
+		return true;
+	}
+
+	void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);	// the mapping keeps its own reference
+	if (view == MAP_FAILED)
+		return false;
+
+	madvise(view, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+	data = (const char*)view;
+	size = (size_t)st.st_size;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (data && data != EmptyFile)
+		munmap((void*)data, size);
+	data = nullptr;
+	size = 0;
+}
+
+void MappedFile::release(size_t offset)
+{
+	if (!data || data == EmptyFile)
+		return;
+	if (offset > size) offset = size;
+
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	size_t length = offset - offset % page;
+	if (length > 0)
+		madvise((void*)data, length, MADV_DONTNEED);
+}
+
+#endif
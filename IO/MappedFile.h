@@ -0,0 +1,37 @@
+#ifndef __MAPPED_FILE_H_
+#define __MAPPED_FILE_H_
+
+#include <string>
+
+// Read-only memory mapping of a whole file (mmap / CreateFileMapping)
+// The contents are valid between open() and close() / destruction.
+class MappedFile
+{
+	const char* data;
+	size_t size;
+
+#ifdef _WIN32
+	void* hFile;
+	void* hMapping;
+#endif
+
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& filename);
+	void close();
+
+	// Hints that the bytes before offset will not be read again, so their
+	// pages can leave memory (long streamed files stay at a flat footprint)
+	void release(size_t offset);
+
+	const char* getData() const { return data; }
+	size_t getSize() const { return size; }
+	bool isOpen() const { return data != nullptr; }
+};
+
+#endif
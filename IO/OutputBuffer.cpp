@@ -0,0 +1,80 @@
+#include "OutputBuffer.h"
+#include <charconv>
+#include <cstring>
+#include <ostream>
+
+// Longest int / long long and the longest fixed double we print (1e308 with 2 decimals)
+static const size_t MaxIntChars = 11;
+static const size_t MaxLongChars = 20;
+static const size_t MaxFixedChars = 330;
+
+OutputBuffer::OutputBuffer(size_t initialCapacity)
+	: length(0), capacity(initialCapacity > 0 ? initialCapacity : 1)
+{
+	data = new char[capacity];
+}
+
+OutputBuffer::~OutputBuffer()
+{
+	delete[] data;
+}
+
+void OutputBuffer::grow(size_t minCapacity)
+{
+	size_t newCapacity = capacity * 2;
+	if (newCapacity < minCapacity) newCapacity = minCapacity;
+
+	char* newData = new char[newCapacity];
+	memcpy(newData, data, length);
+	delete[] data;
+	data = newData;
+	capacity = newCapacity;
+}
+
+void OutputBuffer::reserve(size_t n)
+{
+	if (length + n > capacity)
+		grow(length + n);
+}
+
+void OutputBuffer::append(const char* text)
+{
+	size_t n = strlen(text);
+	reserve(n);
+	memcpy(data + length, text, n);
+	length += n;
+}
+
+void OutputBuffer::append(char c)
+{
+	reserve(1);
+	data[length++] = c;
+}
+
+void OutputBuffer::appendInt(int value)
+{
+	reserve(MaxIntChars);
+	std::to_chars_result r = std::to_chars(data + length, data + capacity, value);
+	length = (size_t)(r.ptr - data);
+}
+
+void OutputBuffer::appendLong(long long value)
+{
+	reserve(MaxLongChars);
+	std::to_chars_result r = std::to_chars(data + length, data + capacity, value);
+	length = (size_t)(r.ptr - data);
+}
+
+void OutputBuffer::appendFixed(double value, int precision)
+{
+	reserve(MaxFixedChars + (size_t)precision);
+	std::to_chars_result r = std::to_chars(data + length, data + capacity, value, std::chars_format::fixed, precision);
+	length = (size_t)(r.ptr - data);
+}
+
+bool OutputBuffer::writeTo(std::ostream& out)
+{
+	out.write(data, (std::streamsize)length);
+	length = 0;
+	return (bool)out;
+}
@@ -0,0 +1,42 @@
+#ifndef __OUTPUT_BUFFER_H_
+#define __OUTPUT_BUFFER_H_
+
+#include <iosfwd>
+#include <cstddef>
+
+// Growable text buffer for building a whole report before writing it
+// Numbers are formatted with std::to_chars (no locale, no stream state);
+// appendFixed prints exactly what "fixed << setprecision(p)" prints.
+class OutputBuffer
+{
+	char* data;
+	size_t length;
+	size_t capacity;
+
+	void grow(size_t minCapacity);
+
+public:
+	explicit OutputBuffer(size_t initialCapacity = 4096);
+	~OutputBuffer();
+
+	OutputBuffer(const OutputBuffer&) = delete;
+	OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+	// Makes room for n more characters in one allocation
+	void reserve(size_t n);
+
+	void append(const char* text);
+	void append(char c);
+	void appendInt(int value);
+	void appendLong(long long value);
+	void appendFixed(double value, int precision);
+
+	// Writes the contents with one call and empties the buffer
+	bool writeTo(std::ostream& out);
+
+	const char* getData() const { return data; }
+	size_t getLength() const { return length; }
+	void clear() { length = 0; }
+};
+
+#endif
@@ -0,0 +1,152 @@
+#include "RTrace.h"
+#include <fstream>
+#include <cstring>
+
+// Consumed records are handed back to the OS in chunks of this size
+static const size_t ReleaseChunk = 16 << 20;
+
+void ToRTraceHeader(const TraceHeader& h, uint64_t count, RTraceHeader& out)
+{
+	memset(&out, 0, sizeof(out));
+	memcpy(out.magic, RTraceMagic, sizeof(out.magic));
+	out.version = RTraceVersion;
+	out.byteOrder = RTraceByteOrder;
+	out.count = count;
+	out.recordSize = sizeof(RTraceRecord);
+	out.N = h.N;   out.G = h.G;   out.V = h.V;
+	out.SN = h.SN; out.SG = h.SG; out.SV = h.SV;
+	out.BO = h.BO; out.BN = h.BN; out.BG = h.BG; out.BV = h.BV;
+	out.AutoP = h.AutoP;
+}
+
+void ToRTraceRecord(const EventRecord& rec, RTraceRecord& out)
+{
+	memset(&out, 0, sizeof(out));
+	out.money = rec.money;
+	out.time = rec.time;
+	out.orderID = rec.orderID;
+	out.size = rec.size;
+	out.extraMoney = rec.extraMoney;
+	out.kind = (uint8_t)rec.kind;
+	out.ordType = (uint8_t)rec.ordType;
+}
+
+void ToEventRecord(const RTraceRecord& rec, EventRecord& out)
+{
+	out.kind = (char)rec.kind;
+	out.ordType = (ORD_TYPE)rec.ordType;
+	out.time = rec.time;
+	out.orderID = rec.orderID;
+	out.size = rec.size;
+	out.money = rec.money;
+	out.extraMoney = rec.extraMoney;
+}
+
+RTraceFile::RTraceFile()
+	: records(nullptr), count(0), released(0)
+{
+	memset(&header, 0, sizeof(header));
+}
+
+bool RTraceFile::fail(const std::string& filename, const std::string& msg)
+{
+	error = filename + ": " + msg;
+	file.close();
+	records = nullptr;
+	count = 0;
+	return false;
+}
+
+bool RTraceFile::isRTrace(const std::string& filename)
+{
+	std::ifstream f(filename, std::ios::binary);
+	char magic[sizeof(RTraceMagic)];
+	return f.read(magic, sizeof(magic)) && memcmp(magic, RTraceMagic, sizeof(magic)) == 0;
+}
+
+bool RTraceFile::open(const std::string& filename)
+{
+	error.clear();
+	released = 0;
+	if (!file.open(filename))
+		return fail(filename, "cannot open file");
+
+	if (file.getSize() < sizeof(RTraceHeader))
+		return fail(filename, "truncated .rtrace header");
+
+	RTraceHeader h;
+	memcpy(&h, file.getData(), sizeof(h));
+	if (memcmp(h.magic, RTraceMagic, sizeof(h.magic)) != 0)
+		return fail(filename, "not an .rtrace file");
+	if (h.byteOrder != RTraceByteOrder)
+		return fail(filename, ".rtrace file was written on a machine with another byte order");
+	if (h.version != RTraceVersion || h.recordSize != sizeof(RTraceRecord))
+		return fail(filename, ".rtrace version " + std::to_string(h.version) +
+			" is not supported (expected " + std::to_string(RTraceVersion) + ")");
+
+	uint64_t expected = sizeof(RTraceHeader) + h.count * sizeof(RTraceRecord);
+	if (h.count > (uint64_t)(SIZE_MAX / sizeof(RTraceRecord)) || (uint64_t)file.getSize() != expected)
+		return fail(filename, "file size does not match its record count (" + std::to_string(h.count) + ")");
+
+	// Same limits as the text header (see TraceParser::readHeader)
+	if (h.N < 0 || h.G < 0 || h.V < 0 || h.SN < 0 || h.SG < 0 || h.SV < 0 ||
+		h.BO < 0 || h.BN < 0 || h.BG < 0 || h.BV < 0 || h.AutoP < 0)
+		return fail(filename, "negative value in the .rtrace header");
+	if ((h.N > 0 && h.SN < 1) || (h.G > 0 && h.SG < 1) || (h.V > 0 && h.SV < 1))
+		return fail(filename, "cook speed below 1 in the .rtrace header");
+
+	header.N = h.N;   header.G = h.G;   header.V = h.V;
+	header.SN = h.SN; header.SG = h.SG; header.SV = h.SV;
+	header.BO = h.BO; header.BN = h.BN; header.BG = h.BG; header.BV = h.BV;
+	header.AutoP = h.AutoP;
+	header.M = (h.count > (uint64_t)INT32_MAX) ? INT32_MAX : (int)h.count;
+
+	// The header is a multiple of 8 bytes and mappings are page aligned,
+	// so the records can be read in place
+	records = (const RTraceRecord*)(file.getData() + sizeof(RTraceHeader));
+	count = h.count;
+	return validateRecords(filename);
+}
+
+// Every record is checked once here, so the readers can index arrays by
+// ordType and rely on sorted times without checking again.
+// Checked pages are released as the scan goes (as in a streamed run), so
+// validating a large file does not pull all of it into memory.
+// Complexity: O(count)
+bool RTraceFile::validateRecords(const std::string& filename)
+{
+	int32_t lastTime = 0;
+	for (uint64_t i = 0; i < count; i++)
+	{
+		const RTraceRecord& r = records[i];
+		std::string problem;
+		if (r.kind != 'R' && r.kind != 'X' && r.kind != 'P')
+			problem = "unknown event kind " + std::to_string(r.kind);
+		else if (r.kind == 'R' && r.ordType >= TYPE_CNT)
+			problem = "unknown order type " + std::to_string(r.ordType);
+		else if (r.kind == 'R' && r.size < 0)
+			problem = "negative order size";
+		else if (r.time < 0)
+			problem = "negative timestep";
+		else if (r.time < lastTime)
+			problem = "timestep " + std::to_string(r.time) + " after " + std::to_string(lastTime) +
+				" (records must be sorted by timestep)";
+		if (!problem.empty())
+			return fail(filename, "record " + std::to_string(i) + ": " + problem);
+		lastTime = r.time;
+
+		if ((i + 1) % (ReleaseChunk / sizeof(RTraceRecord)) == 0)
+			file.release((size_t)((const char*)(records + i + 1) - file.getData()));
+	}
+	return true;
+}
+
+void RTraceFile::release(const RTraceRecord* upTo)
+{
+	size_t offset = (size_t)((const char*)upTo - file.getData());
+	if (offset - released >= ReleaseChunk)
+	{
+		file.release(offset);
+		released = offset;
+	}
+}
@@ -0,0 +1,93 @@
+#ifndef __RTRACE_H_
+#define __RTRACE_H_
+
+#include <string>
+#include <cstdint>
+#include "MappedFile.h"
+#include "TraceParser.h"
+#include "../Events/EventRecord.h"
+
+/*
+.rtrace: binary form of an input file, made by Tools/txt2rtrace
+
+	RTraceHeader        80 bytes
+	RTraceRecord[count] 32 bytes each, sorted by timestep (stable: equal
+	                    timesteps keep their order in the text file)
+
+Fields are stored in the byte order of the machine that wrote the file;
+byteOrder tells a reader on the other kind of machine to refuse the file.
+Bump RTraceVersion whenever either struct changes.
+*/
+
+static const char RTraceMagic[8] = { 'R', 'T', 'R', 'A', 'C', 'E', '\r', '\n' };
+static const uint32_t RTraceVersion = 1;
+static const uint32_t RTraceByteOrder = 0x01020304;
+
+struct RTraceHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrder;
+	uint64_t count;			// number of records
+	uint32_t recordSize;	// sizeof(RTraceRecord)
+	int32_t N, G, V;
+	int32_t SN, SG, SV;
+	int32_t BO, BN, BG, BV;
+	int32_t AutoP;
+	uint32_t reserved[2];
+};
+
+struct RTraceRecord
+{
+	double money;			// R: order money
+	int32_t time;
+	int32_t orderID;
+	int32_t size;			// R: number of dishes
+	int32_t extraMoney;		// P: extra money
+	uint8_t kind;			// 'R', 'X' or 'P'
+	uint8_t ordType;		// R: ORD_TYPE
+	uint8_t reserved[6];
+};
+
+static_assert(sizeof(RTraceHeader) == 80, "RTraceHeader layout changed: bump RTraceVersion");
+static_assert(sizeof(RTraceRecord) == 32, "RTraceRecord layout changed: bump RTraceVersion");
+
+void ToRTraceHeader(const TraceHeader& h, uint64_t count, RTraceHeader& out);
+void ToRTraceRecord(const EventRecord& rec, RTraceRecord& out);
+void ToEventRecord(const RTraceRecord& rec, EventRecord& out);
+
+// Read-only view of a mapped .rtrace file
+class RTraceFile
+{
+	MappedFile file;
+	TraceHeader header;
+	const RTraceRecord* records;
+	uint64_t count;
+	size_t released;		// bytes handed back to MappedFile::release
+	std::string error;
+
+	bool fail(const std::string& filename, const std::string& msg);
+	bool validateRecords(const std::string& filename);
+
+public:
+	RTraceFile();
+
+	// True if the file starts with the .rtrace magic (text inputs do not)
+	static bool isRTrace(const std::string& filename);
+
+	// Maps and validates the file (magic, version, byte order, size, header
+	// values, and every record: kind, order type, sorted times)
+	bool open(const std::string& filename);
+
+	const TraceHeader& getHeader() const { return header; }
+	const RTraceRecord* begin() const { return records; }
+	const RTraceRecord* end() const { return records + count; }
+	uint64_t getCount() const { return count; }
+
+	// Records before upTo will not be read again (see MappedFile::release)
+	void release(const RTraceRecord* upTo);
+
+	const std::string& getError() const { return error; }
+};
+
+#endif
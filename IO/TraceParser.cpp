@@ -0,0 +1,297 @@
+#include "TraceParser.h"
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+static inline bool isSpace(char c)
+{
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static inline bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+// Exact powers of ten (all representable in a double)
+static const double Pow10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Parsed bytes are handed back to the OS in chunks of this size
+static const size_t ReleaseChunk = 16 << 20;
+
+TraceParser::TraceParser()
+	: cur(nullptr), end(nullptr), line(1), eventsLeft(0),
+	  requireSorted(false), lastTime(0), released(0)
+{
+}
+
+bool TraceParser::open(const std::string& fname)
+{
+	filename = fname;
+	error.clear();
+	if (!file.open(fname))
+		return fail("cannot open file");
+
+	cur = file.getData();
+	end = cur + file.getSize();
+	line = 1;
+	eventsLeft = 0;
+	lastTime = 0;
+	released = 0;
+
+	// Skip a UTF-8 byte order mark (files saved by Visual Studio)
+	if (end - cur >= 3 && (unsigned char)cur[0] == 0xEF && (unsigned char)cur[1] == 0xBB && (unsigned char)cur[2] == 0xBF)
+		cur += 3;
+	return true;
+}
+
+bool TraceParser::fail(const std::string& msg)
+{
+	if (error.empty())
+		error = filename + ":" + std::to_string(line) + ": " + msg;
+	return false;
+}
+
+// The whitespace-delimited token starting at p (for error messages)
+std::string TraceParser::tokenAt(const char* p) const
+{
+	if (p >= end)
+		return "end of file";
+	const char* q = p;
+	while (q < end && !isSpace(*q) && q - p < 32)
+		q++;
+	return "'" + std::string(p, q) + "'";
+}
+
+// The hot loops work on local copies of cur / line: stores through a char
+// pointer may alias the members, so the compiler would reload them per byte
+void TraceParser::skipSpace()
+{
+	const char* p = cur;
+	int lineNo = line;
+	while (p < end && isSpace(*p))
+	{
+		if (*p == '\n') lineNo++;
+		p++;
+	}
+	cur = p;
+	line = lineNo;
+}
+
+bool TraceParser::readInt(int& value, const char* what)
+{
+	skipSpace();
+	const char* start = cur;
+	const char* p = cur;
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+'))
+	{
+		negative = (*p == '-');
+		p++;
+	}
+	if (p == end || !isDigit(*p))
+		return fail(std::string("expected ") + what + ", found " + tokenAt(start));
+
+	long long v = 0;
+	while (p < end && isDigit(*p))
+	{
+		v = v * 10 + (*p++ - '0');
+		if (v > (long long)INT_MAX + 1)
+			return fail(std::string(what) + " is out of range: " + tokenAt(start));
+	}
+	if (p < end && !isSpace(*p))
+		return fail(std::string("expected ") + what + ", found " + tokenAt(start));
+	if (negative) v = -v;
+	if (v > INT_MAX)
+		return fail(std::string(what) + " is out of range: " + tokenAt(start));
+
+	value = (int)v;
+	cur = p;
+	return true;
+}
+
+bool TraceParser::readNonNegative(int& value, const char* what)
+{
+	skipSpace();
+	const char* start = cur;
+	if (!readInt(value, what))
+		return false;
+	if (value < 0)
+	{
+		cur = start;
+		return fail(std::string(what) + " must not be negative, found " + tokenAt(start));
+	}
+	return true;
+}
+
+// A cook speed: at least 1 dish per timestep if there are cooks of the type
+// (a type without cooks may declare any speed, it is never used)
+bool TraceParser::readSpeed(int& value, int cooks, const char* what)
+{
+	skipSpace();
+	const char* start = cur;
+	if (!readNonNegative(value, what))
+		return false;
+	if (cooks > 0 && value < 1)
+	{
+		cur = start;
+		return fail(std::string(what) + " must be at least 1, found " + tokenAt(start));
+	}
+	return true;
+}
+
+// Plain decimals ("123", "80.25") are converted as integer mantissa / 10^k,
+// which is correctly rounded while the mantissa fits in 53 bits, i.e. the same
+// double strtod (and the old ifstream loader) produce. Anything else (exponents,
+// very long fractions) falls back to strtod on a copy of the token.
+bool TraceParser::readMoney(double& value, const char* what)
+{
+	skipSpace();
+	const char* start = cur;
+	const char* p = cur;
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+'))
+	{
+		negative = (*p == '-');
+		p++;
+	}
+
+	unsigned long long mantissa = 0;
+	int digits = 0, fraction = 0;
+	bool seenDigit = false, seenPoint = false;
+	while (p < end)
+	{
+		if (isDigit(*p))
+		{
+			seenDigit = true;
+			if (mantissa != 0 || *p != '0') digits++;
+			mantissa = mantissa * 10 + (*p - '0');
+			if (seenPoint) fraction++;
+			if (digits > 15) break;
+		}
+		else if (*p == '.' && !seenPoint)
+			seenPoint = true;
+		else
+			break;
+		p++;
+	}
+
+	if (seenDigit && digits <= 15 && fraction <= 22 && (p == end || isSpace(*p)))
+	{
+		double v = (double)mantissa / Pow10[fraction];
+		value = negative ? -v : v;
+		cur = p;
+		return true;
+	}
+
+	// Slow path: let strtod decide on the whole token
+	const char* q = start;
+	while (q < end && !isSpace(*q))
+		q++;
+	char buffer[64];
+	size_t len = (size_t)(q - start);
+	if (len == 0 || len >= sizeof(buffer))
+		return fail(std::string("expected ") + what + ", found " + tokenAt(start));
+	memcpy(buffer, start, len);
+	buffer[len] = '\0';
+	char* parsedEnd = nullptr;
+	double v = strtod(buffer, &parsedEnd);
+	if (parsedEnd != buffer + len)
+		return fail(std::string("expected ") + what + ", found " + tokenAt(start));
+	value = v;
+	cur = q;
+	return true;
+}
+
+bool TraceParser::readHeader(TraceHeader& h)
+{
+	if (!readNonNegative(h.N, "number of normal cooks") ||
+		!readNonNegative(h.G, "number of vegan cooks") ||
+		!readNonNegative(h.V, "number of VIP cooks") ||
+		!readSpeed(h.SN, h.N, "normal cook speed") ||
+		!readSpeed(h.SG, h.G, "vegan cook speed") ||
+		!readSpeed(h.SV, h.V, "VIP cook speed") ||
+		!readNonNegative(h.BO, "orders before break") ||
+		!readNonNegative(h.BN, "normal break duration") ||
+		!readNonNegative(h.BG, "vegan break duration") ||
+		!readNonNegative(h.BV, "VIP break duration") ||
+		!readNonNegative(h.AutoP, "auto-promotion limit") ||
+		!readNonNegative(h.M, "number of events"))
+		return false;
+
+	eventsLeft = h.M;
+	return true;
+}
+
+bool TraceParser::next(EventRecord& rec)
+{
+	if (eventsLeft == 0 || !error.empty())
+		return false;
+
+	skipSpace();
+	if (cur == end)
+	{
+		eventsLeft = 0;		// fewer event lines than declared
+		return false;
+	}
+
+	const char* start = cur;
+	char kind = *cur++;
+	if ((kind != 'R' && kind != 'X' && kind != 'P') || (cur < end && !isSpace(*cur)))
+	{
+		cur = start;
+		return fail("expected an event type (R, X or P), found " + tokenAt(start));
+	}
+
+	rec.kind = kind;
+	rec.ordType = TYPE_NRM;
+	rec.size = 0;
+	rec.money = 0;
+	rec.extraMoney = 0;
+
+	if (kind == 'R')
+	{
+		skipSpace();
+		const char* typ = cur;
+		if (cur == end || (*cur != 'N' && *cur != 'G' && *cur != 'V') ||
+			(cur + 1 < end && !isSpace(cur[1])))
+			return fail("expected an order type (N, G or V), found " + tokenAt(typ));
+		rec.ordType = (*cur == 'N') ? TYPE_NRM : (*cur == 'G') ? TYPE_VGAN : TYPE_VIP;
+		cur++;
+
+		if (!readNonNegative(rec.time, "arrival timestep") ||
+			!readInt(rec.orderID, "order ID") ||
+			!readNonNegative(rec.size, "order size") ||
+			!readMoney(rec.money, "order money"))
+			return false;
+	}
+	else
+	{
+		if (!readNonNegative(rec.time, "event timestep") ||
+			!readInt(rec.orderID, "order ID"))
+			return false;
+		if (kind == 'P' && !readInt(rec.extraMoney, "extra money"))
+			return false;
+	}
+
+	if (requireSorted && rec.time < lastTime)
+	{
+		cur = start;
+		return fail("events are not sorted by timestep (" + std::to_string(rec.time) +
+			" after " + std::to_string(lastTime) + ")");
+	}
+	lastTime = rec.time;
+
+	size_t offset = (size_t)(cur - file.getData());
+	if (offset - released >= ReleaseChunk)
+	{
+		file.release(offset);
+		released = offset;
+	}
+
+	eventsLeft--;
+	return true;
+}
@@ -0,0 +1,83 @@
+#ifndef __TRACE_PARSER_H_
+#define __TRACE_PARSER_H_
+
+#include <string>
+#include "MappedFile.h"
+#include "../Events/EventRecord.h"
+
+// Restaurant parameters at the top of an input file
+struct TraceHeader
+{
+	int N, G, V;			// number of normal / vegan / VIP cooks
+	int SN, SG, SV;			// their speeds (dishes per timestep)
+	int BO;					// orders a cook serves before a break
+	int BN, BG, BV;			// break durations
+	int AutoP;				// auto-promotion limit
+	int M;					// number of event lines that follow
+};
+
+/*
+Hand-written parser for the input text format, reading a memory-mapped file:
+
+	N G V
+	SN SG SV
+	BO BN BG BV
+	AutoP
+	M
+	R <N|G|V> ts id size money
+	X ts id
+	P ts id extra
+
+Tokens are separated by any whitespace (like the old ifstream >> loader), but
+malformed tokens are errors reported as "<file>:<line>: <message>". A file
+with fewer than M event lines ends early without an error.
+Order IDs must be unique; they are not checked (that would need a set of
+every ID, against the flat memory of streamed runs). With duplicates every
+order is still served exactly once, but X and P reach only the latest order
+with the ID (see OrderIndex).
+No locale, no stream buffers, no per-token allocation. Pages already parsed
+are released as the parser moves on, so memory does not grow with the file.
+*/
+class TraceParser
+{
+	MappedFile file;
+	std::string filename;
+	const char* cur;
+	const char* end;
+	int line;			// line of cur (1-based)
+	int eventsLeft;		// declared events not read yet
+	std::string error;
+
+	bool requireSorted;	// event timesteps must not decrease
+	int lastTime;
+	size_t released;	// bytes handed back to MappedFile::release
+
+	bool fail(const std::string& msg);
+	std::string tokenAt(const char* p) const;
+
+	void skipSpace();
+	bool readInt(int& value, const char* what);
+	bool readNonNegative(int& value, const char* what);
+	bool readSpeed(int& value, int cooks, const char* what);
+	bool readMoney(double& value, const char* what);
+
+public:
+	TraceParser();
+
+	bool open(const std::string& fname);
+
+	// Streaming readers rely on sorted events: a timestep earlier than the
+	// previous line's becomes a parse error instead of being accepted
+	void setRequireSorted(bool sorted) { requireSorted = sorted; }
+
+	// Must be called once, before next()
+	bool readHeader(TraceHeader& header);
+
+	// Reads the next event line; false at the end of the events or on error
+	bool next(EventRecord& rec);
+
+	bool hasError() const { return !error.empty(); }
+	const std::string& getError() const { return error; }
+};
+
+#endif
@@ -1,16 +1,19 @@
 #pragma once
-#include "../Generic_DS/Node.h"
+#include "Generic_DS/Node.h"
+#include "Generic_DS/NodePool.h"
 #include <iostream>
 
 using namespace std;
 
-template <typename T>
+// Alloc: where the nodes come from (see Generic_DS/NodePool.h)
+template <typename T, typename Alloc = HeapNodeAllocator<T>>
 class LinkedList
 {
 private:
 	Node<T>* head;
 	Node<T>* tail;
 	int size;
+	Alloc nodes;
 
 public:
 	LinkedList() {
@@ -23,7 +26,7 @@ public:
 		Node<T>* current = head;
 		while (current != nullptr) {
 			Node<T>* next = current->getNext();
-			delete current;
+			nodes.deallocate(current);
 			current = next;
 		}
 	}
@@ -36,8 +39,9 @@ public:
 		return size == 0;
 	}
 
-	void InsertEnd(T&value) {
-		Node<T>* newNode = new Node<T>(value);
+	// Returns the new node so callers can later remove it in O(1)
+	Node<T>* InsertEnd(T&value) {
+		Node<T>* newNode = nodes.allocate(value);
 		if (isEmpty()) {
 			head = newNode;
 			tail = newNode;
@@ -48,6 +52,7 @@ public:
 			head = newNode;
 		}
 		size++;
+		return newNode;
 	}
 
 
@@ -83,7 +88,7 @@ public:
 		else {
 			tail = nullptr;
 		}
-		delete temp;
+		nodes.deallocate(temp);
 		size--;
 	}
 	// Delete node by value
@@ -106,7 +111,7 @@ public:
 				else {
 					tail = current->getPrev();
 				}
-				delete current;
+				nodes.deallocate(current);
 				size--;
 				return;
 			}
@@ -128,7 +133,7 @@ public:
 		else
 			tail = node->getPrev();
 
-		delete node;
+		nodes.deallocate(node);
 		size--;
 	}
 	// Count nodes
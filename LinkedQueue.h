@@ -2,16 +2,20 @@
 #ifndef LNKDQU
 #define LNKDQU
 #include "Generic_DS/Node.h"// Node<T> must have: T getItem(), void setNext(Node*), Node<T>* getNext()
+#include "Generic_DS/NodePool.h"
 #include <stdexcept>
+#include <utility>
 #include <iostream>
 
-template <typename T>
+// Alloc: where the nodes come from (see Generic_DS/NodePool.h)
+template <typename T, typename Alloc = HeapNodeAllocator<T>>
 class LinkedQueue
 {
 private:
     Node<T>* front;
     Node<T>* back;
     int count;        // Number of elements
+    Alloc nodes;
 
 public:
 
@@ -29,7 +33,7 @@ public:
 
     // Move constructor
     LinkedQueue(LinkedQueue&& other) noexcept
-        : front(other.front), back(other.back), count(other.count)
+        : front(other.front), back(other.back), count(other.count), nodes(std::move(other.nodes))
     {
         other.front = nullptr;
         other.back = nullptr;
@@ -45,6 +49,7 @@ public:
             front = other.front;
             back = other.back;
             count = other.count;
+            nodes = std::move(other.nodes);
 
             other.front = nullptr;
             other.back = nullptr;
@@ -56,7 +61,7 @@ public:
     // Add item to the back (FIFO)
     void enqueue(const T& item)
     {
-        Node<T>* newNode = new Node<T>(item);
+        Node<T>* newNode = nodes.allocate(item);
         count++;
 
         if (isEmpty())
@@ -81,7 +86,7 @@ public:
         if (front == nullptr)
             back = nullptr;
 
-        delete temp;
+        nodes.deallocate(temp);
         count--;
         return item;
     }
@@ -114,7 +119,7 @@ public:
         {
             Node<T>* temp = front;
             front = front->getNext();
-            delete temp;
+            nodes.deallocate(temp);
         }
         back = nullptr;
         count = 0;
@@ -149,14 +154,14 @@ public:
         front = front->getNext();
         if (front == nullptr)
             back = nullptr;
-        delete temp;
+        nodes.deallocate(temp);
         count--;
 	}
 };
 
 // Optional: global operator<< if you really want cout << queue 
-template <typename T>
-std::ostream& operator<<(std::ostream& os, const LinkedQueue<T>& q)
+template <typename T, typename Alloc>
+std::ostream& operator<<(std::ostream& os, const LinkedQueue<T, Alloc>& q)
 {
     q.print(os);
     return os;
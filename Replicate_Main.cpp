@@ -0,0 +1,59 @@
+// Monte Carlo replications of one input file with random cook injuries
+// usage: restaurant_replicate <input file> [-n replications] [-j threads] [-s seed]
+//   -n: number of replications (default 100)
+//   -j: worker threads (default: all hardware threads)
+//   -s: base seed; replication r uses the Philox stream (seed, r)
+#include "Sim/ReplicationRunner.h"
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <chrono>
+
+static void Usage(const char* program)
+{
+	std::cerr << "usage: " << program << " <input file> [-n replications] [-j threads] [-s seed]\n";
+}
+
+int main(int argc, char* argv[])
+{
+	std::string input;
+	int replications = 100;
+	int threads = 0;
+	unsigned long seed = 1;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = (i + 1 < argc);
+		if (arg == "-n" && hasValue) replications = atoi(argv[++i]);
+		else if (arg == "-j" && hasValue) threads = atoi(argv[++i]);
+		else if (arg == "-s" && hasValue) seed = strtoul(argv[++i], nullptr, 10);
+		else if (input.empty() && arg[0] != '-') input = arg;
+		else
+		{
+			Usage(argv[0]);
+			return 1;
+		}
+	}
+	if (input.empty() || replications <= 0)
+	{
+		Usage(argv[0]);
+		return 1;
+	}
+
+	ReplicationRunner runner(input, replications, threads, (uint32_t)seed);
+
+	auto start = std::chrono::steady_clock::now();
+	bool ok = runner.run();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if (!ok)
+	{
+		std::cerr << "ERROR: " << runner.getError() << "\n";
+		return 2;
+	}
+
+	runner.printTable(std::cout);
+	std::cout << "Elapsed: " << seconds << " s\n";
+	return 0;
+}
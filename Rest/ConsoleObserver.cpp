@@ -0,0 +1,23 @@
+#include "ConsoleObserver.h"
+#include <iostream>
+
+ConsoleObserver::ConsoleObserver(bool waitForEnter)
+	: waitEachStep(waitForEnter)
+{
+}
+
+void ConsoleObserver::PrintMessage(std::string msg) const
+{
+	std::cout << msg << '\n';
+}
+
+void ConsoleObserver::OnTimeStep(int currentTime)
+{
+	std::cout << "Time Step: " << currentTime << std::endl;
+
+	if (waitEachStep)
+	{
+		std::string line;
+		std::getline(std::cin, line);
+	}
+}
@@ -0,0 +1,19 @@
+#ifndef __CONSOLE_OBSERVER_H_
+#define __CONSOLE_OBSERVER_H_
+
+#include "SimObserver.h"
+
+// Prints simulation messages to stdout (headless build)
+// In interactive mode it also waits for ENTER after every timestep
+class ConsoleObserver : public SimObserver
+{
+	bool waitEachStep;
+
+public:
+	ConsoleObserver(bool waitForEnter);
+
+	virtual void PrintMessage(std::string msg) const override;
+	virtual void OnTimeStep(int currentTime) override;
+};
+
+#endif
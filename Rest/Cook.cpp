@@ -1,42 +1,70 @@
 #include "Cook.h"
 #include "Order.h"
+#include "CookPool.h"
+#include "CookTable.h"
+#include "../Generic_DS/AllocTracker.h"
 #include <algorithm>
+#include <new>
 using namespace std;
 
-Cook::Cook(int id, COOK_TYPE t, int baseSpd, int breakAft, int breakDur)
-    : ID(id), type(t), baseSpeed(baseSpd), currentSpeed(baseSpd),
-    status(AVAILABLE), currentOrder(nullptr),
+Cook::Cook(int id, COOK_TYPE t, int baseSpd, int breakAft, int breakDur, CookTable* pTable)
+    : ID(id), type(t), table(pTable), currentOrder(nullptr),
     breakAfter(breakAft), breakDuration(breakDur),
-    ordersServedSinceBreak(0), breakEndTime(-1), injuryEndTime(-1),
+    ordersServedSinceBreak(0),
     totalOrdersServed(0), normalOrdersServed(0),
     veganOrdersServed(0), vipOrdersServed(0),
-    totalBusyTime(0), totalIdleTime(0), totalBreakTime(0)
+    pool(nullptr), poolSlot(-1)
 {
+    row = table->add(this, baseSpd);
 }
 
 Cook::~Cook()
 {
 }
 
+void* Cook::operator new(size_t size)
+{
+    AllocTracker::onAlloc(ALLOC_COOKS, size);
+    return ::operator new(size);
+}
+
+void Cook::operator delete(void* p, size_t size)
+{
+    AllocTracker::onFree(ALLOC_COOKS, size);
+    ::operator delete(p);
+}
+
 // Basic Getters (O(1))
 int Cook::GetID() const { return ID; }
 COOK_TYPE Cook::GetType() const { return type; }
-int Cook::getSpeed() const { return currentSpeed; }
-int Cook::getBaseSpeed() const { return baseSpeed; }
-int Cook::getCurrentSpeed() const { return currentSpeed; }
-COOK_STATUS Cook::getStatus() const { return status; }
+int Cook::getSpeed() const { return table->currentSpeed[row]; }
+int Cook::getBaseSpeed() const { return table->baseSpeed[row]; }
+int Cook::getCurrentSpeed() const { return table->currentSpeed[row]; }
+COOK_STATUS Cook::getStatus() const { return (COOK_STATUS)table->status[row]; }
 Order* Cook::getCurrentOrder() const { return currentOrder; }
+int Cook::getBreakEndTime() const { return table->breakEndTime[row]; }
+int Cook::getInjuryEndTime() const { return table->injuryEndTime[row]; }
+int Cook::getPoolSlot() const { return poolSlot; }
 
 // Basic Getters (O(1))
-bool Cook::isAvailable() const { return status == AVAILABLE; }
-bool Cook::isBusy() const { return status == BUSY; }
-bool Cook::isOnBreak() const { return status == ON_BREAK; }
-bool Cook::isInjured() const { return status == INJURED; }
+bool Cook::isAvailable() const { return table->status[row] == AVAILABLE; }
+bool Cook::isBusy() const { return table->status[row] == BUSY; }
+bool Cook::isOnBreak() const { return table->status[row] == ON_BREAK; }
+bool Cook::isInjured() const { return table->status[row] == INJURED; }
 
 // Basic Setters (O(1))
 void Cook::setID(int id) { ID = id; }
 void Cook::setType(COOK_TYPE t) { type = t; }
-void Cook::setSpeed(int s) { baseSpeed = s; currentSpeed = s; }
+void Cook::setSpeed(int s) { table->baseSpeed[row] = s; table->currentSpeed[row] = s; }
+void Cook::setPool(CookPool* pPool, int slot) { pool = pPool; poolSlot = slot; }
+
+// Every status change goes through here so the free-cook pool stays exact (O(1))
+void Cook::setStatus(COOK_STATUS s)
+{
+    table->status[row] = s;
+    if (pool)
+        pool->setFree(poolSlot, s == AVAILABLE);
+}
 
 // Order Management (O(1))
 void Cook::assignOrder(Order* pOrder, int currentTime)
@@ -44,9 +72,10 @@ void Cook::assignOrder(Order* pOrder, int currentTime)
     if (!pOrder || !isAvailable()) return;
 
     currentOrder = pOrder;
-    status = BUSY;
+    setStatus(BUSY);
     pOrder->setStatus(SRV);
     pOrder->setServTime(currentTime);
+    pOrder->setCook(this);
 }
 
 Order* Cook::finishCurrentOrder()
@@ -55,7 +84,7 @@ Order* Cook::finishCurrentOrder()
 
     Order* completedOrder = currentOrder;
     currentOrder = nullptr;
-    status = AVAILABLE;
+    setStatus(AVAILABLE);
 
     // Update statistics based on order type
     totalOrdersServed++;
@@ -77,8 +106,8 @@ Order* Cook::finishCurrentOrder()
 // Break Management (O(1))
 void Cook::startBreak(int currentTime)
 {
-    status = ON_BREAK;
-    breakEndTime = currentTime + breakDuration;
+    setStatus(ON_BREAK);
+    table->breakEndTime[row] = currentTime + breakDuration;
     ordersServedSinceBreak = 0;
 
     // Restore speed during break
@@ -87,8 +116,8 @@ void Cook::startBreak(int currentTime)
 
 void Cook::endBreak()
 {
-    status = AVAILABLE;
-    breakEndTime = -1;
+    setStatus(AVAILABLE);
+    table->breakEndTime[row] = -1;
 }
 
 bool Cook::needsBreak() const
@@ -99,51 +128,29 @@ bool Cook::needsBreak() const
 // Injury Management (O(1))
 void Cook::setInjured(int currentTime, int recoveryDuration)
 {
-    status = INJURED;
-    injuryEndTime = currentTime + recoveryDuration;
+    setStatus(INJURED);
+    table->injuryEndTime[row] = currentTime + recoveryDuration;
 }
 
 void Cook::recover()
 {
-    status = AVAILABLE;
-    injuryEndTime = -1;
+    // A cook injured mid-order goes back to it
+    setStatus(currentOrder ? BUSY : AVAILABLE);
+    table->injuryEndTime[row] = -1;
 }
 
 // Fatigue System (O(1))
 void Cook::applyFatigue()
 {
     // Fatigue rule: reduce speed by 5% after each order (minimum 1)
-    currentSpeed = max(1, (int)(currentSpeed * 0.95));
+    int& speed = table->currentSpeed[row];
+    speed = max(1, (int)(speed * 0.95));
 }
 
 void Cook::restoreSpeed()
 {
     // Full recovery during break
-    currentSpeed = baseSpeed;
-}
-
-// Timestep Update (O(1))
-void Cook::updateStatus(int currentTime)
-{
-    // break should end ?
-    if (isOnBreak() && currentTime >= breakEndTime)
-    {
-        endBreak();
-    }
-
-    // injury recovery complete?
-    if (isInjured() && currentTime >= injuryEndTime)
-    {
-        recover();
-    }
-
-    // Update statistics
-    if (isBusy())
-        totalBusyTime++;
-    else if (isAvailable())
-        totalIdleTime++;
-    else if (isOnBreak() || isInjured())
-        totalBreakTime++;
+    table->currentSpeed[row] = table->baseSpeed[row];
 }
 
 // Getters for statistics (O(1))
@@ -151,13 +158,14 @@ int Cook::getTotalOrdersServed() const { return totalOrdersServed; }
 int Cook::getNormalOrdersServed() const { return normalOrdersServed; }
 int Cook::getVeganOrdersServed() const { return veganOrdersServed; }
 int Cook::getVIPOrdersServed() const { return vipOrdersServed; }
-int Cook::getTotalBusyTime() const { return totalBusyTime; }
-int Cook::getTotalIdleTime() const { return totalIdleTime; }
-int Cook::getTotalBreakTime() const { return totalBreakTime; }
+int Cook::getTotalBusyTime() const { return table->busyTime[row]; }
+int Cook::getTotalIdleTime() const { return table->idleTime[row]; }
+int Cook::getTotalBreakTime() const { return table->breakTime[row]; }
 
 double Cook::getUtilization() const
 {
-    int total = totalBusyTime + totalIdleTime + totalBreakTime;
+    int busy = table->busyTime[row];
+    int total = busy + table->idleTime[row] + table->breakTime[row];
     if (total == 0) return 0.0;
-    return (double)totalBusyTime / total * 100.0;
+    return (double)busy / total * 100.0;
 }
\ No newline at end of file
@@ -1,9 +1,12 @@
 #ifndef __COOK_H_
 #define __COOK_H_
 
-#include "..\Defs.h"
+#include "../Defs.h"
+#include <cstddef>
 
 class Order;
+class CookPool;
+class CookTable;
 
 enum COOK_STATUS
 {
@@ -13,43 +16,46 @@ enum COOK_STATUS
     INJURED       // Health emergency (unavailable)
 };
 
+// Status, speeds, break / injury end times and the busy / idle / break
+// counters are stored in the restaurant's CookTable (row `row`); the
+// per-timestep update runs over the whole table (CookTable::updateStatuses)
 class Cook
 {
 private:
     int ID;
     COOK_TYPE type;           // VIP, Normal, or Vegan
 
-    // Speed tracking
-    int baseSpeed;            // Base dishes per timestep (from input)
-    int currentSpeed;         // Current speed (affected by fatigue)
+    CookTable* table;
+    int row;
 
-    // Status tracking
-    COOK_STATUS status;       // Current status
 	Order* currentOrder;      // Pointer to order being prepared (if free, it'll be nullptr)
 
     // Break management
 	int breakAfter;           // Orders before break (Break Orders (BO) from input)
     int breakDuration;        // Break duration in timesteps (Break Normal (BN) /BVip/ Break Vegan (BV) from input)
     int ordersServedSinceBreak;  // Counter for break
-    int breakEndTime;         // When current break ends ( will output -1 if not on break)
 
-    // Injury management
-    int injuryEndTime;        // When recovery ends (will output -1 if not injured)
-
-    // Statistics
+    // Statistics (busy / idle / break time: see CookTable)
     int totalOrdersServed;    // Total orders handled
     int normalOrdersServed;   // Normal orders count
     int veganOrdersServed;    // Vegan orders count
     int vipOrdersServed;      // VIP orders count
-    int totalBusyTime;        // Time spent cooking
-    int totalIdleTime;        // Time spent available but not assigned
-    int totalBreakTime;       // Time spent on breaks/injury
+
+    // Free-cook pool of this cook's type (kept in sync on every status change)
+    CookPool* pool;
+    int poolSlot;
+
+    void setStatus(COOK_STATUS s);
 
 public:
-    // Constructor
-    Cook(int id, COOK_TYPE t, int baseSpd, int breakAfter, int breakDur);
+    // Constructor (the cook's state gets a new row of table)
+    Cook(int id, COOK_TYPE t, int baseSpd, int breakAfter, int breakDur, CookTable* table);
     virtual ~Cook();
 
+    // Counted as ALLOC_COOKS (see AllocTracker)
+    static void* operator new(size_t size);
+    static void operator delete(void* p, size_t size);
+
     // Basic getters
     int GetID() const;
     COOK_TYPE GetType() const;
@@ -58,6 +64,9 @@ public:
     int getCurrentSpeed() const;
     COOK_STATUS getStatus() const;
     Order* getCurrentOrder() const;
+    int getBreakEndTime() const;
+    int getInjuryEndTime() const;
+    int getPoolSlot() const;     // Position of the cook in its type's list
 
     // Status checking (O(1) complexity)
     bool isAvailable() const;    // Can take new order now
@@ -69,6 +78,7 @@ public:
     void setID(int id);
     void setType(COOK_TYPE t);
     void setSpeed(int s);
+    void setPool(CookPool* pPool, int slot);
 
     // Order assignment (O(1) complexity)
     void assignOrder(Order* pOrder, int currentTime);
@@ -87,9 +97,6 @@ public:
     void applyFatigue();         // Called after each order
     void restoreSpeed();         // Called during breaks
 
-    // Timestep update (O(1) complexity)
-    void updateStatus(int currentTime);
-
 	//To get just some statistics
     int getTotalOrdersServed() const;
     int getNormalOrdersServed() const;
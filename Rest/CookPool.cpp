@@ -0,0 +1,151 @@
+#include "CookPool.h"
+#include "Cook.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Index of the lowest set bit (word must be non-zero)
+static int lowestSetBit(unsigned long long word)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    if (_BitScanForward(&index, (unsigned long)(word & 0xFFFFFFFFull)))
+        return (int)index;
+    _BitScanForward(&index, (unsigned long)(word >> 32));
+    return (int)index + 32;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+// Index of the highest set bit (word must be non-zero)
+static int highestSetBit(unsigned long long word)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    if (_BitScanReverse(&index, (unsigned long)(word >> 32)))
+        return (int)index + 32;
+    _BitScanReverse(&index, (unsigned long)(word & 0xFFFFFFFFull));
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(word);
+#endif
+}
+
+CookPool::CookPool()
+    : cookCount(0), capacity(64), freeCount(0)
+{
+    cooks = new Cook*[capacity];
+    words = new unsigned long long[capacity / 64];
+    summary = new unsigned long long[1];
+    words[0] = 0;
+    summary[0] = 0;
+}
+
+CookPool::~CookPool()
+{
+    delete[] cooks;
+    delete[] words;
+    delete[] summary;
+}
+
+void CookPool::grow()
+{
+    int oldWords = capacity / 64;
+    int oldSummary = (oldWords + 63) / 64;
+    capacity *= 2;
+    int newWords = capacity / 64;
+    int newSummary = (newWords + 63) / 64;
+
+    Cook** newCooks = new Cook*[capacity];
+    for (int i = 0; i < cookCount; i++)
+        newCooks[i] = cooks[i];
+
+    unsigned long long* newWordArr = new unsigned long long[newWords];
+    for (int i = 0; i < newWords; i++)
+        newWordArr[i] = (i < oldWords) ? words[i] : 0;
+
+    unsigned long long* newSummaryArr = new unsigned long long[newSummary];
+    for (int i = 0; i < newSummary; i++)
+        newSummaryArr[i] = (i < oldSummary) ? summary[i] : 0;
+
+    delete[] cooks;
+    delete[] words;
+    delete[] summary;
+    cooks = newCooks;
+    words = newWordArr;
+    summary = newSummaryArr;
+}
+
+int CookPool::add(Cook* pCook)
+{
+    if (cookCount == capacity) grow();
+
+    int slot = cookCount++;
+    cooks[slot] = pCook;
+    setFree(slot, pCook->isAvailable());
+    return slot;
+}
+
+// Complexity: O(1)
+void CookPool::setFree(int slot, bool isFree)
+{
+    int w = slot >> 6;
+    unsigned long long bit = 1ull << (slot & 63);
+    bool wasFree = (words[w] & bit) != 0;
+    if (wasFree == isFree) return;
+
+    if (isFree)
+    {
+        words[w] |= bit;
+        summary[w >> 6] |= 1ull << (w & 63);
+        freeCount++;
+    }
+    else
+    {
+        words[w] &= ~bit;
+        if (words[w] == 0)
+            summary[w >> 6] &= ~(1ull << (w & 63));
+        freeCount--;
+    }
+}
+
+// Complexity: O(1) for up to 4096 cooks per type
+Cook* CookPool::first() const
+{
+    if (freeCount == 0) return nullptr;
+
+    int summaryCount = (capacity / 64 + 63) / 64;
+    for (int s = 0; s < summaryCount; s++)
+    {
+        if (summary[s] == 0) continue;
+        int w = (s << 6) + lowestSetBit(summary[s]);
+        return cooks[(w << 6) + lowestSetBit(words[w])];
+    }
+    return nullptr;
+}
+
+Cook* CookPool::last() const
+{
+    if (freeCount == 0) return nullptr;
+
+    int summaryCount = (capacity / 64 + 63) / 64;
+    for (int s = summaryCount - 1; s >= 0; s--)
+    {
+        if (summary[s] == 0) continue;
+        int w = (s << 6) + highestSetBit(summary[s]);
+        return cooks[(w << 6) + highestSetBit(words[w])];
+    }
+    return nullptr;
+}
+
+int CookPool::getFreeCount() const
+{
+    return freeCount;
+}
+
+int CookPool::getSize() const
+{
+    return cookCount;
+}
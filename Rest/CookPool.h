@@ -0,0 +1,46 @@
+#ifndef __COOK_POOL_H_
+#define __COOK_POOL_H_
+
+class Cook;
+
+// Free-cook set for ONE cook type (two-level bitset with find-first-set)
+// Every cook of the type gets a slot in its list order; the bit of a slot is
+// set while that cook is AVAILABLE. Cook flips its own bit on every status
+// change, so picking "the first available cook in list order" never scans
+// the cook list and never allocates.
+//
+// Complexity:
+//   setFree       -> O(1)
+//   first / last  -> O(1) (one summary word per 4096 cooks)
+class CookPool
+{
+    Cook** cooks;                   // slot -> cook
+    unsigned long long* words;      // bit i of words[w] -> slot 64*w + i is free
+    unsigned long long* summary;    // bit w of summary[s] -> words[64*s + w] != 0
+    int cookCount;
+    int capacity;                   // slots allocated (multiple of 64)
+    int freeCount;
+
+    void grow();
+
+public:
+    CookPool();
+    ~CookPool();
+
+    CookPool(const CookPool&) = delete;
+    CookPool& operator=(const CookPool&) = delete;
+
+    // Registers a cook (call in list order), returns its slot
+    int add(Cook* pCook);
+
+    void setFree(int slot, bool isFree);
+
+    // Lowest / highest slot available cook (nullptr if none)
+    Cook* first() const;
+    Cook* last() const;
+
+    int getFreeCount() const;
+    int getSize() const;
+};
+
+#endif
@@ -0,0 +1,151 @@
+#include "CookTable.h"
+#include "Cook.h"
+#include <climits>
+
+CookTable::CookTable()
+    : count(0), capacity(64)
+{
+    status = new int[capacity];
+    baseSpeed = new int[capacity];
+    currentSpeed = new int[capacity];
+    breakEndTime = new int[capacity];
+    injuryEndTime = new int[capacity];
+    busyTime = new int[capacity];
+    idleTime = new int[capacity];
+    breakTime = new int[capacity];
+    cooks = new Cook*[capacity];
+}
+
+CookTable::~CookTable()
+{
+    delete[] status;
+    delete[] baseSpeed;
+    delete[] currentSpeed;
+    delete[] breakEndTime;
+    delete[] injuryEndTime;
+    delete[] busyTime;
+    delete[] idleTime;
+    delete[] breakTime;
+    delete[] cooks;
+}
+
+static void growArray(int*& arr, int count, int newCapacity)
+{
+    int* newArr = new int[newCapacity];
+    for (int i = 0; i < count; i++)
+        newArr[i] = arr[i];
+    delete[] arr;
+    arr = newArr;
+}
+
+void CookTable::grow()
+{
+    capacity *= 2;
+    growArray(status, count, capacity);
+    growArray(baseSpeed, count, capacity);
+    growArray(currentSpeed, count, capacity);
+    growArray(breakEndTime, count, capacity);
+    growArray(injuryEndTime, count, capacity);
+    growArray(busyTime, count, capacity);
+    growArray(idleTime, count, capacity);
+    growArray(breakTime, count, capacity);
+
+    Cook** newCooks = new Cook*[capacity];
+    for (int i = 0; i < count; i++)
+        newCooks[i] = cooks[i];
+    delete[] cooks;
+    cooks = newCooks;
+}
+
+int CookTable::add(Cook* pCook, int speed)
+{
+    if (count == capacity) grow();
+
+    int row = count++;
+    status[row] = AVAILABLE;
+    baseSpeed[row] = speed;
+    currentSpeed[row] = speed;
+    breakEndTime[row] = -1;
+    injuryEndTime[row] = -1;
+    busyTime[row] = 0;
+    idleTime[row] = 0;
+    breakTime[row] = 0;
+    cooks[row] = pCook;
+    return row;
+}
+
+// Complexity: O(C) + O(1) per cook whose break / injury ends
+void CookTable::updateStatuses(int currentTime)
+{
+    const int* st = status;
+    const int* breakEnd = breakEndTime;
+    const int* injuryEnd = injuryEndTime;
+    const int n = count;
+
+    // Is any break or injury over? (most timesteps: none)
+    int due = 0;
+    for (int r = 0; r < n; r++)
+        due |= ((st[r] == ON_BREAK) & (currentTime >= breakEnd[r]))
+             | ((st[r] == INJURED) & (currentTime >= injuryEnd[r]));
+
+    // Transitions go through Cook to keep the free-cook pools in sync
+    if (due)
+    {
+        for (int r = 0; r < n; r++)
+        {
+            if (st[r] == ON_BREAK && currentTime >= breakEnd[r])
+                cooks[r]->endBreak();
+            else if (st[r] == INJURED && currentTime >= injuryEnd[r])
+                cooks[r]->recover();
+        }
+    }
+
+    accountTime(1);
+}
+
+// Complexity: O(C)
+void CookTable::accountTime(int ticks)
+{
+    if (ticks <= 0) return;
+
+    const int* st = status;
+    int* busy = busyTime;
+    int* idle = idleTime;
+    int* out = breakTime;
+    const int n = count;    // local: the stores cannot change it
+    for (int r = 0; r < n; r++)
+    {
+        busy[r] += (st[r] == BUSY) ? ticks : 0;
+        idle[r] += (st[r] == AVAILABLE) ? ticks : 0;
+        out[r] += (st[r] == ON_BREAK || st[r] == INJURED) ? ticks : 0;
+    }
+}
+
+// Complexity: O(C)
+int CookTable::nextEndTime() const
+{
+    const int* st = status;
+    const int* breakEnd = breakEndTime;
+    const int* injuryEnd = injuryEndTime;
+
+    const int n = count;
+
+    int earliest = INT_MAX;
+    for (int r = 0; r < n; r++)
+    {
+        // Compare masks (all ones / zero) blend the end time of the cook's
+        // status, INT_MAX if it is not out; written with masks because
+        // compilers do not vectorize a select feeding a min reduction
+        int onBreak = -(st[r] == ON_BREAK);
+        int injured = -(st[r] == INJURED);
+        int end = (breakEnd[r] & onBreak) | (injuryEnd[r] & injured)
+                | (INT_MAX & ~(onBreak | injured));
+        earliest = (end < earliest) ? end : earliest;
+    }
+    return (earliest == INT_MAX) ? -1 : earliest;
+}
+
+int CookTable::getSize() const
+{
+    return count;
+}
@@ -0,0 +1,58 @@
+#ifndef __COOK_TABLE_H_
+#define __COOK_TABLE_H_
+
+class Cook;
+
+// State of every cook of one restaurant, one array per field
+// A Cook is a row of the table: its status, speeds, break / injury end
+// times and busy / idle / break counters live here, so the end-of-timestep
+// update is a few straight passes over int arrays (compare + select per
+// cook, no branches: the compiler vectorizes them) instead of a call per
+// cook through three linked lists.
+//
+// Complexity (C = cooks):
+//   updateStatuses / accountTime / nextEndTime -> O(C), sequential
+//   add                                        -> O(1) amortized
+class CookTable
+{
+    friend class Cook;
+
+    int* status;            // COOK_STATUS
+    int* baseSpeed;
+    int* currentSpeed;
+    int* breakEndTime;      // -1 if not on break
+    int* injuryEndTime;     // -1 if not injured
+    int* busyTime;
+    int* idleTime;
+    int* breakTime;         // on break or injured
+    Cook** cooks;           // row -> cook, for the (rare) status transitions
+
+    int count;
+    int capacity;
+
+    void grow();
+
+public:
+    CookTable();
+    ~CookTable();
+
+    CookTable(const CookTable&) = delete;
+    CookTable& operator=(const CookTable&) = delete;
+
+    // New AVAILABLE row for pCook, returns its row
+    int add(Cook* pCook, int speed);
+
+    // End of timestep currentTime: ends due breaks and injuries, then bills
+    // the timestep to each cook's counter of its (new) status
+    void updateStatuses(int currentTime);
+
+    // Bills ticks timesteps with no status change to every cook
+    void accountTime(int ticks);
+
+    // Earliest break end / injury recovery (-1 if no cook is out)
+    int nextEndTime() const;
+
+    int getSize() const;
+};
+
+#endif
@@ -4,7 +4,9 @@
 Order::Order(int ID, ORD_TYPE r_Type)
     : ID(ID), type(r_Type), status(WAIT), Distance(0), totalMoney(0.0),
     ArrTime(0), ServTime(0), FinishTime(0), Deadline(0), isLate(false),
-    OrderSize(0), assignedCook(nullptr)
+    OrderSize(0), assignedCook(nullptr), ServiceHandle(-1),
+    PreemptHandle(-1), QueueHandle(-1), AgingHandle(-1),
+    PromoteTimer(-1), WaitNode(nullptr)
 {
 }
 
@@ -45,6 +47,24 @@ int Order::getDeadline() const {
 bool Order::getIsLate() const {
     return isLate;
 }
+int Order::getServiceHandle() const {
+    return ServiceHandle;
+}
+int Order::getPreemptHandle() const {
+    return PreemptHandle;
+}
+int Order::getQueueHandle() const {
+    return QueueHandle;
+}
+int Order::getAgingHandle() const {
+    return AgingHandle;
+}
+int Order::getPromoteTimer() const {
+    return PromoteTimer;
+}
+Node<Order*>* Order::getWaitNode() const {
+    return WaitNode;
+}
 
 // --- Setters ---
 void Order::setStatus(ORD_STATUS s) {
@@ -74,6 +94,27 @@ void Order::setDeadline(int deadline) {
 void Order::setIsLate(bool late) {
     isLate = late;
 }
+void Order::setCook(Cook* pCook) {
+    assignedCook = pCook;
+}
+void Order::setServiceHandle(int handle) {
+    ServiceHandle = handle;
+}
+void Order::setPreemptHandle(int handle) {
+    PreemptHandle = handle;
+}
+void Order::setQueueHandle(int handle) {
+    QueueHandle = handle;
+}
+void Order::setAgingHandle(int handle) {
+    AgingHandle = handle;
+}
+void Order::setPromoteTimer(int handle) {
+    PromoteTimer = handle;
+}
+void Order::setWaitNode(Node<Order*>* node) {
+    WaitNode = node;
+}
 
 //==================================
 // VIP Priority calculation
@@ -1,14 +1,15 @@
 #ifndef __ORDER_H_
 #define __ORDER_H_
 
-#include "..\Defs.h"
+#include "../Defs.h"
 
 class Cook;
+template <typename T> class Node;
 
 class Order
 {
 protected:
-    int ID;                    // Each order has a unique ID (from 1 --> 999)
+    int ID;                    // Each order has a unique ID (any int, looked up through OrderIndex)
     ORD_TYPE type;             // Order type: Normal, Vegan, VIP
     ORD_STATUS status;         // WAIT, SRV, DONE
     int Distance;              // Distance (in meters) between order location and restaurant
@@ -21,6 +22,12 @@ protected:
     // === Added as required by project specification ===
     int OrderSize;             // Number of dishes in the order 
     Cook* assignedCook;
+    int ServiceHandle;         // Handle of the entry in the in-service heap (-1 if not in service)
+    int PreemptHandle;         // Handle in the preemption index (-1 if not a preemption candidate)
+    int QueueHandle;           // Handle in its VIPQueue segment heap (-1 if not a waiting VIP)
+    int AgingHandle;           // Handle in the segment's arrival-time heap (VIPQueue)
+    int PromoteTimer;          // Auto-promotion timer of a waiting Normal order (-1 if none)
+    Node<Order*>* WaitNode;    // Its node in waitNormal (nullptr if not there)
 
 public:
     // Constructor
@@ -42,6 +49,12 @@ public:
     Cook* getCook() const;
     int getDeadline() const;
     bool getIsLate() const;
+    int getServiceHandle() const;
+    int getPreemptHandle() const;
+    int getQueueHandle() const;
+    int getAgingHandle() const;
+    int getPromoteTimer() const;
+    Node<Order*>* getWaitNode() const;
 
     // --- Setters ---
     void setStatus(ORD_STATUS s);
@@ -54,10 +67,17 @@ public:
     void setType(ORD_TYPE newType) { type = newType; }
     void setDeadline(int deadline);
     void setIsLate(bool late);
+    void setCook(Cook* pCook);
+    void setServiceHandle(int handle);
+    void setPreemptHandle(int handle);
+    void setQueueHandle(int handle);
+    void setAgingHandle(int handle);
+    void setPromoteTimer(int handle);
+    void setWaitNode(Node<Order*>* node);
 
 
 	//==================================
-    // VIP Priority calculation
+    // VIP Priority calculation (before aging, see VIPQueue)
     double calculateVIPPriority() const;
     
     // Deadline calculation: D = AT + f(SIZE, Price)
@@ -0,0 +1,119 @@
+#include "OrderIndex.h"
+#include "Order.h"
+
+OrderIndex::OrderIndex()
+    : capacity(64), count(0)
+{
+    table = new Entry[capacity];
+    for (int i = 0; i < capacity; i++)
+        table[i].order = nullptr;
+}
+
+OrderIndex::~OrderIndex()
+{
+    delete[] table;
+}
+
+// Fibonacci hashing: spreads consecutive IDs over the whole table
+int OrderIndex::slotOf(int id) const
+{
+    unsigned int h = (unsigned int)id * 2654435769u;
+    return (int)(h & (unsigned int)(capacity - 1));
+}
+
+// Keep the load factor under 1/2 so probe chains stay short
+void OrderIndex::grow()
+{
+    Entry* oldTable = table;
+    int oldCapacity = capacity;
+
+    capacity *= 2;
+    table = new Entry[capacity];
+    for (int i = 0; i < capacity; i++)
+        table[i].order = nullptr;
+
+    for (int i = 0; i < oldCapacity; i++)
+    {
+        if (!oldTable[i].order) continue;
+        int slot = slotOf(oldTable[i].id);
+        while (table[slot].order)
+            slot = (slot + 1) & (capacity - 1);
+        table[slot] = oldTable[i];
+    }
+    delete[] oldTable;
+}
+
+void OrderIndex::insert(Order* pOrd, ORD_LOCATION location)
+{
+    if (!pOrd) return;
+
+    int id = pOrd->GetID();
+    int slot = slotOf(id);
+    while (table[slot].order && table[slot].id != id)
+        slot = (slot + 1) & (capacity - 1);
+
+    if (!table[slot].order)
+    {
+        if (2 * (count + 1) > capacity)
+        {
+            grow();
+            insert(pOrd, location);
+            return;
+        }
+        count++;
+    }
+
+    table[slot].id = id;
+    table[slot].order = pOrd;
+    table[slot].location = location;
+}
+
+OrderIndex::Entry* OrderIndex::find(int id)
+{
+    int slot = slotOf(id);
+    while (table[slot].order)
+    {
+        if (table[slot].id == id)
+            return &table[slot];
+        slot = (slot + 1) & (capacity - 1);
+    }
+    return nullptr;
+}
+
+bool OrderIndex::erase(int id)
+{
+    Entry* e = find(id);
+    if (!e) return false;
+
+    // Backward-shift the rest of the probe chain into the hole
+    int hole = (int)(e - table);
+    int slot = (hole + 1) & (capacity - 1);
+    while (table[slot].order)
+    {
+        int home = slotOf(table[slot].id);
+        // Move the entry only if its home slot is not between the hole and its slot
+        bool movable = (slot > hole) ? (home <= hole || home > slot)
+                                     : (home <= hole && home > slot);
+        if (movable)
+        {
+            table[hole] = table[slot];
+            hole = slot;
+        }
+        slot = (slot + 1) & (capacity - 1);
+    }
+    table[hole].order = nullptr;
+    count--;
+    return true;
+}
+
+bool OrderIndex::erase(const Order* pOrd)
+{
+    Entry* e = find(pOrd->GetID());
+    if (!e || e->order != pOrd) return false;
+    return erase(pOrd->GetID());
+}
+
+int OrderIndex::getSize() const
+{
+    return count;
+}
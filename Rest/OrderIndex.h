@@ -0,0 +1,65 @@
+#ifndef __ORDER_INDEX_H_
+#define __ORDER_INDEX_H_
+
+#include "../Defs.h"
+
+class Order;
+
+// Where a live order currently sits
+enum ORD_LOCATION
+{
+    LOC_WAIT_NRM,   // waitNormal (Order::getWaitNode() is valid)
+    LOC_WAIT_VGAN,  // waitVegan
+    LOC_WAIT_VIP,   // waitVIP
+    LOC_SRV         // in service (Order::getServiceHandle() is valid)
+};
+
+// Order ID -> location index (flat open-addressing hash table)
+// Holds every order from arrival until it finishes or is cancelled, so the
+// Cancel/Promote callbacks reach their order without walking waitNormal.
+// Linear probing with backward-shift deletion (no tombstones).
+//
+// Order IDs are expected to be unique among live orders. Duplicates are not
+// supported, only kept harmless: the latest order inserted under an ID owns
+// its entry (Cancel/Promote reach that one), and erasing an order leaves an
+// entry that another order took over alone.
+// Complexity: insert / find / erase -> O(1) expected
+class OrderIndex
+{
+public:
+    struct Entry {
+        int id;
+        Order* order;               // nullptr marks an empty slot
+        ORD_LOCATION location;
+    };
+
+private:
+    Entry* table;
+    int capacity;       // always a power of two
+    int count;
+
+    int slotOf(int id) const;
+    void grow();
+
+public:
+    OrderIndex();
+    ~OrderIndex();
+
+    OrderIndex(const OrderIndex&) = delete;
+    OrderIndex& operator=(const OrderIndex&) = delete;
+
+    // Adds the order or moves it to a new location
+    void insert(Order* pOrd, ORD_LOCATION location);
+
+    // nullptr if the ID is not (or no longer) indexed
+    Entry* find(int id);
+
+    bool erase(int id);
+
+    // Removes the order's entry, unless another order owns it by now
+    bool erase(const Order* pOrd);
+
+    int getSize() const;
+};
+
+#endif
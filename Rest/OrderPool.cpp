@@ -0,0 +1,70 @@
+#include "OrderPool.h"
+#include "../Generic_DS/AllocTracker.h"
+#include <new>
+
+OrderPool::OrderPool()
+    : slabs(nullptr), slabCount(0), slabCapacity(0), usedInLast(SlabSize),
+      freeList(nullptr), liveCount(0)
+{
+}
+
+// Order has nothing to clean up, so the slabs are freed without running
+// the destructors of the orders still in them
+OrderPool::~OrderPool()
+{
+    AllocTracker::onFree(ALLOC_ORDERS, sizeof(Order), liveCount);
+    for (int i = 0; i < slabCount; i++)
+        delete[] slabs[i];
+    delete[] slabs;
+}
+
+void OrderPool::addSlab()
+{
+    if (slabCount == slabCapacity)
+    {
+        slabCapacity = (slabCapacity == 0) ? 16 : slabCapacity * 2;
+        Slot** bigger = new Slot*[slabCapacity];
+        for (int i = 0; i < slabCount; i++)
+            bigger[i] = slabs[i];
+        delete[] slabs;
+        slabs = bigger;
+    }
+    slabs[slabCount++] = new Slot[SlabSize];
+    usedInLast = 0;
+}
+
+Order* OrderPool::create(int id, ORD_TYPE type)
+{
+    Slot* slot;
+    if (freeList)
+    {
+        slot = freeList;
+        freeList = slot->nextFree;
+    }
+    else
+    {
+        if (usedInLast == SlabSize)
+            addSlab();
+        slot = &slabs[slabCount - 1][usedInLast++];
+    }
+    liveCount++;
+    AllocTracker::onAlloc(ALLOC_ORDERS, sizeof(Order));
+    return new (slot->storage) Order(id, type);
+}
+
+void OrderPool::release(Order* pOrd)
+{
+    if (!pOrd) return;
+
+    pOrd->~Order();
+    Slot* slot = reinterpret_cast<Slot*>(pOrd);
+    slot->nextFree = freeList;
+    freeList = slot;
+    liveCount--;
+    AllocTracker::onFree(ALLOC_ORDERS, sizeof(Order));
+}
+
+int OrderPool::getLiveCount() const
+{
+    return liveCount;
+}
@@ -0,0 +1,51 @@
+#ifndef __ORDER_POOL_H_
+#define __ORDER_POOL_H_
+
+#include "../Defs.h"
+#include "Order.h"
+
+// Slab allocator for the orders of one Restaurant
+// Orders are constructed in place in slabs of SlabSize slots, so they sit
+// next to each other in arrival order instead of scattered over the heap,
+// and every Restaurant allocates from its own slabs (no allocator lock
+// shared between replication / sweep threads). Released slots are reused
+// through a free list; all slabs are freed at once with the pool, together
+// with the orders still in it.
+//
+// Complexity:
+//   create / release  -> O(1) (one slab allocation per SlabSize orders)
+//   destruction       -> O(slabs)
+class OrderPool
+{
+    static const int SlabSize = 1024;
+
+    union Slot {
+        Slot* nextFree;
+        alignas(Order) unsigned char storage[sizeof(Order)];
+    };
+
+    Slot** slabs;
+    int slabCount;
+    int slabCapacity;
+    int usedInLast;         // slots of the last slab handed out so far
+    Slot* freeList;         // released slots
+    int liveCount;
+
+    void addSlab();
+
+public:
+    OrderPool();
+    ~OrderPool();
+
+    OrderPool(const OrderPool&) = delete;
+    OrderPool& operator=(const OrderPool&) = delete;
+
+    Order* create(int id, ORD_TYPE type);
+
+    // The order must come from this pool and not be used afterwards
+    void release(Order* pOrd);
+
+    int getLiveCount() const;
+};
+
+#endif
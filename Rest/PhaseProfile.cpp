@@ -0,0 +1,132 @@
+#include "PhaseProfile.h"
+#include <fstream>
+#include <ostream>
+#include <iomanip>
+
+void LatencyHistogram::clear()
+{
+    for (int b = 0; b < Buckets; b++)
+        counts[b] = 0;
+    count = 0;
+    sum = 0;
+    minValue = UINT64_MAX;
+    maxValue = 0;
+}
+
+// Complexity: O(Buckets)
+uint64_t LatencyHistogram::quantile(double q) const
+{
+    if (count == 0)
+        return 0;
+    uint64_t rank = (uint64_t)(q * (double)(count - 1)) + 1;     // 1-based
+    uint64_t seen = 0;
+    for (int b = 0; b < Buckets; b++)
+    {
+        seen += counts[b];
+        if (seen >= rank)
+        {
+            uint64_t high = (b + 1 < Buckets) ? BucketLow(b + 1) - 1 : UINT64_MAX;
+            return (high < maxValue) ? high : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+PhaseProfile::PhaseProfile(int period)
+    : samplePeriod(period > 0 ? period : 1), untilSample(1), sampling(false), sampledSteps(0),
+      startTicks(PhaseClockNow()), startTime(std::chrono::steady_clock::now())
+{
+}
+
+const char* PhaseProfile::PhaseName(SIM_PHASE phase)
+{
+    static const char* const Names[PHASE_CNT] = {
+        "ExecuteEvents", "CheckAutoPromotion", "UpdateServiceList", "TriggerRandomInjuries",
+        "AssignVIPOrders", "AssignNormalOrders", "AssignVeganOrders", "Drawing",
+        "UpdateCookStatuses"
+    };
+    return Names[phase];
+}
+
+double PhaseProfile::ticksPerNs() const
+{
+#ifdef PHASE_CLOCK_TSC
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+    uint64_t ticks = PhaseClockNow() - startTicks;
+    if (ns < 1e6)       // under a millisecond: too short to measure the rate
+        return 1.0;
+    return (double)ticks / ns;
+#else
+    return 1.0;
+#endif
+}
+
+void PhaseProfile::writeJson(std::ostream& out) const
+{
+    double scale = 1.0 / ticksPerNs();      // ns per tick
+
+    out << std::fixed << std::setprecision(1);
+    out << "{\n";
+#ifdef PHASE_CLOCK_TSC
+    out << "  \"clock\": \"tsc\",\n";
+#else
+    out << "  \"clock\": \"steady_clock\",\n";
+#endif
+    out << "  \"ticks_per_ns\": " << std::setprecision(4) << ticksPerNs() << std::setprecision(1) << ",\n";
+    out << "  \"sample_period\": " << samplePeriod << ",\n";
+    out << "  \"sampled_steps\": " << sampledSteps << ",\n";
+
+    // Share of each phase in the time of the sampled timesteps
+    uint64_t allTicks = 0;
+    for (int p = 0; p < PHASE_CNT; p++)
+        allTicks += phases[p].getSum();
+
+    out << "  \"phases\": [";
+
+    for (int p = 0; p < PHASE_CNT; p++)
+    {
+        const LatencyHistogram& h = phases[p];
+        uint64_t n = h.getCount();
+
+        out << (p ? ",\n" : "\n");
+        out << "    {\n";
+        out << "      \"name\": \"" << PhaseName((SIM_PHASE)p) << "\",\n";
+        out << "      \"count\": " << n << ",\n";
+        out << "      \"total_ns\": " << h.getSum() * scale << ",\n";
+        out << "      \"share_pct\": " << (allTicks ? 100.0 * h.getSum() / allTicks : 0.0) << ",\n";
+        out << "      \"mean_ns\": " << (n ? h.getSum() * scale / n : 0.0) << ",\n";
+        out << "      \"min_ns\": " << h.getMin() * scale << ",\n";
+        out << "      \"p50_ns\": " << h.quantile(0.50) * scale << ",\n";
+        out << "      \"p90_ns\": " << h.quantile(0.90) * scale << ",\n";
+        out << "      \"p99_ns\": " << h.quantile(0.99) * scale << ",\n";
+        out << "      \"p999_ns\": " << h.quantile(0.999) * scale << ",\n";
+        out << "      \"max_ns\": " << h.getMax() * scale << ",\n";
+
+        // [low_ns, high_ns, count] of the non-empty buckets
+        out << "      \"histogram\": [";
+        bool first = true;
+        for (int b = 0; b < LatencyHistogram::Buckets; b++)
+        {
+            uint64_t c = h.getBucketCount(b);
+            if (c == 0)
+                continue;
+            uint64_t low = LatencyHistogram::BucketLow(b);
+            uint64_t high = (b + 1 < LatencyHistogram::Buckets) ? LatencyHistogram::BucketLow(b + 1) - 1 : UINT64_MAX;
+            out << (first ? "" : ", ") << "[" << low * scale << ", " << high * scale << ", " << c << "]";
+            first = false;
+        }
+        out << "]\n";
+        out << "    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+bool PhaseProfile::writeJson(const std::string& filename) const
+{
+    std::ofstream out(filename);
+    if (!out.is_open())
+        return false;
+    writeJson(out);
+    out.close();
+    return !out.fail();
+}
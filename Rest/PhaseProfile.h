@@ -0,0 +1,219 @@
+#ifndef __PHASE_PROFILE_H_
+#define __PHASE_PROFILE_H_
+
+#include <cstdint>
+#include <string>
+#include <iosfwd>
+#include <chrono>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PHASE_CLOCK_TSC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define PHASE_CLOCK_TSC
+#endif
+
+// The phases of a simulation timestep, in the order they run
+enum SIM_PHASE
+{
+    PHASE_EVENTS,           // ExecuteEvents
+    PHASE_AUTO_PROMOTION,   // CheckAutoPromotionOptimized
+    PHASE_SERVICE,          // UpdateServiceList
+    PHASE_INJURIES,         // TriggerRandomInjuries (injury runs only)
+    PHASE_ASSIGN_VIP,       // AssignVIPOrders
+    PHASE_ASSIGN_NORMAL,    // AssignNormalOrders
+    PHASE_ASSIGN_VEGAN,     // AssignVeganOrders
+    PHASE_DRAWING,          // FillDrawingList + UpdateInterface (GUI)
+    PHASE_COOK_STATUS,      // UpdateCookStatuses
+    PHASE_CNT
+};
+
+// Time stamp in clock ticks: the TSC on x86 (a few cycles to read),
+// steady_clock nanoseconds elsewhere
+inline uint64_t PhaseClockNow()
+{
+#ifdef PHASE_CLOCK_TSC
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Log-linear histogram of durations: exact below 2^SubBits, then 2^SubBits
+// buckets per power of two, so a bucket is at most 1/2^SubBits wide relative
+// to its values (12.5%). Fixed size, no allocation.
+// Complexity: record -> O(1)
+class LatencyHistogram
+{
+public:
+    static const int SubBits = 3;
+    static const int SubBuckets = 1 << SubBits;
+    static const int Buckets = (64 - SubBits + 1) * SubBuckets;
+
+private:
+    uint64_t counts[Buckets];
+    uint64_t count;
+    uint64_t sum;
+    uint64_t minValue;
+    uint64_t maxValue;
+
+    static int highestSetBit(uint64_t value)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        if (_BitScanReverse(&index, (unsigned long)(value >> 32)))
+            return (int)index + 32;
+        _BitScanReverse(&index, (unsigned long)(value & 0xFFFFFFFFull));
+        return (int)index;
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+public:
+    LatencyHistogram() { clear(); }
+
+    void clear();
+
+    static int BucketOf(uint64_t value)
+    {
+        if (value < (uint64_t)SubBuckets)
+            return (int)value;
+        int shift = highestSetBit(value) - SubBits;
+        return ((shift + 1) << SubBits) + (int)((value >> shift) & (SubBuckets - 1));
+    }
+
+    // Smallest value of bucket b (the largest is BucketLow(b + 1) - 1)
+    static uint64_t BucketLow(int b)
+    {
+        int group = b >> SubBits;
+        uint64_t sub = (uint64_t)(b & (SubBuckets - 1));
+        if (group == 0)
+            return sub;
+        return (SubBuckets + sub) << (group - 1);
+    }
+
+    void record(uint64_t value)
+    {
+        counts[BucketOf(value)]++;
+        count++;
+        sum += value;
+        if (value < minValue) minValue = value;
+        if (value > maxValue) maxValue = value;
+    }
+
+    // Upper bound of the bucket holding the q-quantile (0 <= q <= 1)
+    uint64_t quantile(double q) const;
+
+    uint64_t getCount() const { return count; }
+    uint64_t getSum() const { return sum; }
+    uint64_t getMin() const { return count ? minValue : 0; }
+    uint64_t getMax() const { return maxValue; }
+    uint64_t getBucketCount(int b) const { return counts[b]; }
+};
+
+/*
+Where the time of a run goes, phase by phase: one LatencyHistogram of
+clock ticks per SIM_PHASE, filled by PHASE_TIMER scopes in the Restaurant
+(see setPhaseProfile). Ticks are converted to nanoseconds when the profile
+is written, with the TSC rate measured over the profile's lifetime.
+
+Only one timestep in samplePeriod is timed (all of its phases): a timestep
+of a silent run takes a couple of microseconds, and reading the clock 16
+times in each would cost far more than the 2% a profile may add. Untimed
+timesteps pay one flag test per phase.
+
+A profile belongs to one restaurant (one thread): its counters are not
+synchronized and beginTimeStep steps through that restaurant's timesteps.
+Replications, branches or sweep runs each need their own.
+
+The timers only exist in builds with RESTAURANT_PHASE_TIMERS defined
+(CMake option of the same name); otherwise PHASE_TIMER and PHASE_STEP
+expand to nothing and a profile stays empty.
+*/
+class PhaseProfile
+{
+    LatencyHistogram phases[PHASE_CNT];
+
+    int samplePeriod;
+    int untilSample;
+    bool sampling;          // the current timestep is timed
+    uint64_t sampledSteps;
+
+    uint64_t startTicks;
+    std::chrono::steady_clock::time_point startTime;
+
+public:
+#ifdef RESTAURANT_PHASE_TIMERS
+    static const bool Enabled = true;
+#else
+    static const bool Enabled = false;
+#endif
+
+    static const int DefaultSamplePeriod = 16;
+
+    // Times one timestep in samplePeriod (1: every timestep)
+    explicit PhaseProfile(int samplePeriod = DefaultSamplePeriod);
+
+    static const char* PhaseName(SIM_PHASE phase);
+
+    // Called at the start of every timestep
+    void beginTimeStep()
+    {
+        sampling = (--untilSample == 0);
+        if (sampling)
+        {
+            untilSample = samplePeriod;
+            sampledSteps++;
+        }
+    }
+
+    bool isSampling() const { return sampling; }
+
+    void record(SIM_PHASE phase, uint64_t ticks) { phases[phase].record(ticks); }
+    const LatencyHistogram& getPhase(SIM_PHASE phase) const { return phases[phase]; }
+
+    // Clock ticks per nanosecond (1 without a TSC)
+    double ticksPerNs() const;
+
+    // Totals, quantiles and the non-empty buckets of every phase, in ns
+    void writeJson(std::ostream& out) const;
+    bool writeJson(const std::string& filename) const;
+};
+
+// Times the rest of the enclosing scope into profile (if not null and
+// sampling this timestep)
+class ScopedPhaseTimer
+{
+    PhaseProfile* profile;
+    SIM_PHASE phase;
+    uint64_t start;
+
+public:
+    ScopedPhaseTimer(PhaseProfile* pProfile, SIM_PHASE p)
+        : profile((pProfile && pProfile->isSampling()) ? pProfile : nullptr), phase(p),
+          start(profile ? PhaseClockNow() : 0)
+    {
+    }
+
+    ~ScopedPhaseTimer()
+    {
+        if (profile)
+            profile->record(phase, PhaseClockNow() - start);
+    }
+
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+};
+
+#ifdef RESTAURANT_PHASE_TIMERS
+#define PHASE_STEP(profile) do { if (profile) (profile)->beginTimeStep(); } while (0)
+#define PHASE_TIMER(profile, phase) ScopedPhaseTimer phaseTimer(profile, phase)
+#else
+#define PHASE_STEP(profile) ((void)0)
+#define PHASE_TIMER(profile, phase) ((void)0)
+#endif
+
+#endif
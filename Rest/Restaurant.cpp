@@ -2,294 +2,515 @@
 #include "../Events/ArrivalEvent.h"
 #include "../Events/CancellationEvent.h"
 #include "../Events/PromotionEvent.h"
+#include "../Events/EventRecord.h"
 #include "../Rest/Cook.h"
+#include "../IO/TraceParser.h"
+#include "../IO/RTrace.h"
+#include "../IO/OutputBuffer.h"
+#include "RunMonitor.h"
 #include <fstream>
 #include <string>
 #include <cmath>
-#include <iomanip>
+#include <climits>
+#include <cassert>
 
 Restaurant::Restaurant()
     : pGUI(nullptr),
+      pObserver(nullptr),
+      phaseProfile(nullptr),
       TotalWaitTime(0),
       TotalServTime(0),
       TotalTurnaround(0),
       CountFinished(0),
       lateOrderCount(0),
       autoPromotedCount(0),
-      AutoP(0)
+      AutoP(0),
+      streamEvents(false),
+      eventStream(nullptr),
+      streamedUpTo(0),
+      streamFailed(false),
+      binaryTrace(nullptr),
+      nextRecord(nullptr),
+      sharedTrace(nullptr),
+      traceCursor(EventTrace::Start()),
+      injuriesEnabled(false),
+      arrivedCount(0),
+      cancelledCount(0),
+      executedEvents(0),
+      simulatedSteps(0),
+      lastTimeStep(0),
+      memoryReport(false),
+      memorySamples(nullptr),
+      memorySampleInterval(1),
+      nextMemorySample(0)
 {
+    for (int i = 0; i < TYPE_CNT; i++)
+        outputCount[i] = 0;
 }
 
 Restaurant::~Restaurant()
 {
-    if (pGUI) delete pGUI;
+    // pGUI is created and destroyed by RunSimulation (RestaurantGUI.cpp)
+    delete eventStream;
+    delete binaryTrace;
+
+    // Cooks are owned by the restaurant (replications create and destroy
+    // many of them in one process); orders go with orderPool
+    LinkedList<Cook*>* cookLists[] = { &normalCooks, &veganCooks, &vipCooks };
+    for (int i = 0; i < 3; i++)
+    {
+        for (Node<Cook*>* node = cookLists[i]->getHead(); node; node = node->getNext())
+            delete node->getItem();
+    }
 }
 
+// Pops only the orders whose finish time has come
+// Complexity: O(F log B) where F = finished this step, B = busy cooks
 void Restaurant::UpdateServiceList(int CurrentTimeStep)
 {
-    Node<Order*>* curr = inService.getHead();
+    PHASE_TIMER(phaseProfile, PHASE_SERVICE);
+    Order* ord;
+    int finishTime;
 
-    while (curr)
+    while (inService.peek(ord, finishTime) && finishTime <= CurrentTimeStep)
     {
-        Order* ord = curr->getItem();
+        inService.pop(ord, finishTime);
+        ord->setServiceHandle(-1);
+        preemptible.erase(ord->getPreemptHandle());
+        ord->setPreemptHandle(-1);
+        orderIndex.erase(ord);
         Cook* ck = ord->getCook();
 
-        int serviceDuration =
-            (ord->GetOrderSize() + ck->getCurrentSpeed() - 1) / ck->getCurrentSpeed();
+        int serviceDuration = finishTime - ord->GetServTime();
+
+        // Finish order
+        ord->setFinishTime(CurrentTimeStep);
+        ord->setStatus(DONE);
 
-        if (CurrentTimeStep - ord->GetServTime() >= serviceDuration)
+        // Calculate deadline and check if late
+        int deadline = ord->calculateDeadline();
+        ord->setDeadline(deadline);
+
+        if (CurrentTimeStep > deadline)
         {
-            // Finish order
-            ord->setFinishTime(CurrentTimeStep);
-            ord->setStatus(DONE);
-            
-            // Calculate deadline and check if late
-            int deadline = ord->calculateDeadline();
-            ord->setDeadline(deadline);
-            
-            if (CurrentTimeStep > deadline)
-            {
-                ord->setIsLate(true);
-                lateOrderCount++;
-            }
+            ord->setIsLate(true);
+            lateOrderCount++;
+        }
 
-            int waitTime = ord->GetServTime() - ord->GetArrTime();
-            int turnaround = ord->GetFinishTime() - ord->GetArrTime();
+        // Waiting time counts once per order, here: from arrival to the
+        // (last) start of its service
+        int waitTime = ord->GetServTime() - ord->GetArrTime();
+        int turnaround = ord->GetFinishTime() - ord->GetArrTime();
 
-            TotalWaitTime += waitTime;
-            TotalServTime += serviceDuration;
-            TotalTurnaround += turnaround;
-            CountFinished++;
+        TotalWaitTime += waitTime;
+        TotalServTime += serviceDuration;
+        TotalTurnaround += turnaround;
+        CountFinished++;
 
-            // Free cook properly
-            ck->finishCurrentOrder();
+        // Free cook properly
+        ck->finishCurrentOrder();
 
-            Node<Order*>* toDelete = curr;
-            curr = curr->getNext();
+        finished.InsertEnd(ord);
+    }
+}
 
-            inService.DeleteNodeByPointer(toDelete);
-            finished.InsertEnd(ord);
-        }
-        else
-        {
-            curr = curr->getNext();
-        }
+// Hands the order to the cook and schedules its completion
+// The speed cannot change while the cook is busy, so the finish time is final
+// Normal orders on Normal cooks also become preemption candidates
+// Complexity: O(log B)
+void Restaurant::StartService(Cook* cook, Order* order, int currentTime)
+{
+    cook->assignOrder(order, currentTime);
+
+    int speed = cook->getCurrentSpeed();
+    assert(speed >= 1);     // the trace loaders reject zero speeds
+    int serviceDuration = (order->GetOrderSize() + speed - 1) / speed;
+    order->setServiceHandle(inService.push(order, currentTime + serviceDuration));
+    orderIndex.insert(order, LOC_SRV);
+
+    if (cook->GetType() == COOK_NRM && order->GetType() == TYPE_NRM)
+    {
+        PreemptKey key = { -currentTime, cook->getPoolSlot() };
+        order->setPreemptHandle(preemptible.push(cook, key));
     }
 }
 
 
-// The main simulation loop 
-void Restaurant::RunSimulation()
+// One timestep of the simulation: every phase, in this exact order
+void Restaurant::SimulateTimeStep(int CurrentTimeStep)
+{
+    simulatedSteps++;
+    lastTimeStep = CurrentTimeStep;
+    if (memorySamples && CurrentTimeStep >= nextMemorySample)
+        WriteMemorySample(CurrentTimeStep);
+    PHASE_STEP(phaseProfile);
+    ExecuteEvents(CurrentTimeStep);
+
+    CheckAutoPromotionOptimized(CurrentTimeStep);
+    UpdateServiceList(CurrentTimeStep);
+    if (injuriesEnabled)
+        TriggerRandomInjuries(CurrentTimeStep);
+    AssignVIPOrders(CurrentTimeStep);      // Highest priority first
+    AssignNormalOrders(CurrentTimeStep);    // Then Normal orders
+    AssignVeganOrders(CurrentTimeStep);     // Then vegan orders...
+}
+
+// to finish simulation: nothing waiting, nothing in service, no pending events
+bool Restaurant::HasPendingWork()
+{
+    bool hasWaiting = !waitNormal.isEmpty() || !waitVegan.isEmpty() || !waitVIP.isEmpty();
+    bool hasServing = !inService.isEmpty();
+    bool hasFutureEvents = NextEventTime() >= 0;    // O(1)
+
+    if (streamFailed)
+        return false;
+    return hasWaiting || hasServing || hasFutureEvents;
+}
+
+// Update all cook statuses each timestep
+// Complexity: O(C), one pass over the cook table's arrays
+void Restaurant::UpdateCookStatuses(int currentTime)
+{
+    PHASE_TIMER(phaseProfile, PHASE_COOK_STATUS);
+    cookTable.updateStatuses(currentTime);
+}
+
+// Closes timestep currentTime (cook status update) and returns the next
+// timestep to simulate: currentTime + 1, or in jump mode the next timestep
+// where the state can change. Returns -1 if nothing can ever change again.
+int Restaurant::AdvanceTime(int currentTime, bool jumpMode)
 {
-    pGUI = new GUI();
-    if (!pGUI) return;
+    UpdateCookStatuses(currentTime);
 
-    PROG_MODE mode = pGUI->getGUIMode();
+    // Injuries may strike at any timestep, so none can be skipped
+    if (!jumpMode || injuriesEnabled)
+        return currentTime + 1;
 
-    if (mode == MODE_INTR || mode == MODE_STEP || mode == MODE_SLNT || mode == MODE_DEMO)
+    int nextTime = NextStateChangeTime(currentTime);
+    if (nextTime < 0)
     {
-        string filename = "test.txt";
+        if (pObserver)
+            pObserver->PrintMessage("No further state change possible, stopping at step " + to_string(currentTime));
+        return -1;
+    }
+    BillSkippedTimeSteps(nextTime - currentTime - 1);
+    return nextTime;
+}
 
-		// Interactive & Step-by-step and checking file existence and asking user for it
-        if (mode == MODE_INTR || mode == MODE_STEP)
-        {
-            bool opened = false;
-            while (!opened)
-            {
-                pGUI->PrintMessage("Enter input file name (e.g. test.txt): ");
-                filename = pGUI->GetString();
-                if (filename.empty()) filename = "test.txt";
+// Headless run (no window): load, simulate, write the output file
+// Silent mode uses next-event time advance, the other modes go step by step
+// and report each step to the observer (if any)
+bool Restaurant::RunBatch(const string& inputFile, const string& outputFile, PROG_MODE mode)
+{
+    if (!LoadInputFile(inputFile))
+        return false;
 
-                ifstream test(filename);
-                if (test.is_open())
-                {
-                    test.close();
-                    opened = true;
-                    pGUI->PrintMessage("Loading: " + filename);
-                }
-                else
-                {
-                    pGUI->PrintMessage("File not found! Try again...");
-                }
-            }
+    // Streaming writes finished orders as they come (see FlushFinishedOrders)
+    ofstream streamOut;
+    OutputBuffer streamBuffer(StreamFlushSize);
+    if (streamEvents)
+    {
+        streamOut.open(outputFile);
+        if (!streamOut.is_open())
+        {
+            ReportError("Cannot write to output file: " + outputFile);
+            return false;
         }
+        streamBuffer.append("FT\tID\tAT\tWT\tST\n");
+    }
 
-		// Demo mode and checking file existence and asking user for it
-        if (mode == MODE_DEMO || mode == MODE_SLNT)
-        {
-            bool opened = false;
-            while (!opened)
-            {
-                pGUI->PrintMessage("Enter input file name for DEMO (e.g. test.txt): ");
-                filename = pGUI->GetString();
-                if (filename.empty()) filename = "test.txt";
+    bool jumpMode = (mode == MODE_SLNT);
+    int CurrentTimeStep = 1;
 
-                ifstream test(filename);
-                if (test.is_open())
-                {
-                    test.close();
-                    opened = true;
-                    pGUI->PrintMessage("Loading: " + filename);
-                }
-                else
-                {
-                    pGUI->PrintMessage("File not found! Try again...");
-                }
-            }
+    while (true)
+    {
+        SimulateTimeStep(CurrentTimeStep);
+        if (streamEvents)
+        {
+            FlushFinishedOrders(streamBuffer);
+            if (streamBuffer.getLength() >= StreamFlushSize)
+                streamBuffer.writeTo(streamOut);
         }
 
-        LoadInputFile(filename);
+        if (pObserver && mode != MODE_SLNT)
+            pObserver->OnTimeStep(CurrentTimeStep);
 
-        int CurrentTimeStep = 1;
+        if (!HasPendingWork())
+            break;
 
-        while (true)
-        {
-            ExecuteEvents(CurrentTimeStep);
+        CurrentTimeStep = AdvanceTime(CurrentTimeStep, jumpMode);
+        if (CurrentTimeStep < 0)
+            break;
+    }
+
+    if (streamFailed)
+        return false;
+
+    if (streamEvents)
+    {
+        WriteStatistics(streamBuffer);
+        streamBuffer.writeTo(streamOut);
+        streamOut.close();
+    }
+    else if (!WriteOutputFile(outputFile))
+        return false;
 
-            //in this exact order
-            CheckAutoPromotionOptimized(CurrentTimeStep);
-            UpdateServiceList(CurrentTimeStep);
-            AssignVIPOrders(CurrentTimeStep);      // Highest priority first
-            AssignNormalOrders(CurrentTimeStep);    // Then Normal orders
+    if (pObserver)
+        pObserver->PrintMessage("Simulation Finished Successfully!");
+    return true;
+}
 
-            AssignVeganOrders(CurrentTimeStep);     // Then vegan orders...
+void Restaurant::setStreaming(bool streaming)
+{
+    streamEvents = streaming;
+}
 
-            FillDrawingList();
-            pGUI->UpdateInterface();
-            pGUI->PrintMessage("Time Step: " + to_string(CurrentTimeStep));
+void Restaurant::setRandomInjuries(bool enabled, uint32_t seed, uint32_t stream)
+{
+    injuriesEnabled = enabled;
+    injuryRng = Philox4x32(seed, stream);
+}
 
-            if (mode == MODE_INTR || mode == MODE_STEP)
-                pGUI->waitForClick();
-            else if (mode == MODE_DEMO)
-            {
-                clock_t delay = clock();
-				while (clock() - delay < 400) {}  // for delay to visualize
-            }
+void Restaurant::setVIPAging(const VIPAging& aging)
+{
+    waitVIP.setAging(aging);
+}
 
-			// to finish simulation
-            bool hasWaiting = !waitNormal.isEmpty() || !waitVegan.isEmpty() || !waitVIP.isEmpty();
-            bool hasServing = !inService.isEmpty();
-            bool hasFutureEvents = false;
+bool Restaurant::RunWithoutReport(const string& inputFile)
+{
+    if (!LoadInputFile(inputFile))
+        return false;
+    return SimulateWithoutReport();
+}
 
-            Node<Event*>* p = Events.getHead();
-            while (p)
-            {
-                if (p->getItem()->getEventTime() >= CurrentTimeStep)
-                {
-                    hasFutureEvents = true;
-                    break;
-                }
-                p = p->getNext();
-            }
+bool Restaurant::SimulateWithoutReport(RunMonitor* monitor)
+{
+    const int MonitorInterval = 64;     // loop iterations between two checks
+    int untilCheck = MonitorInterval;
 
-            if (!hasWaiting && !hasServing && !hasFutureEvents)
-                break;
-            
-            // Update all cook statuses each timestep
-            Node<Cook*>* cookNode = normalCooks.getHead();
-            while (cookNode)
-            {
-                cookNode->getItem()->updateStatus(CurrentTimeStep);
-                cookNode = cookNode->getNext();
-            }
-            cookNode = veganCooks.getHead();
-            while (cookNode)
-            {
-                cookNode->getItem()->updateStatus(CurrentTimeStep);
-                cookNode = cookNode->getNext();
-            }
-            cookNode = vipCooks.getHead();
-            while (cookNode)
-            {
-                cookNode->getItem()->updateStatus(CurrentTimeStep);
-                cookNode = cookNode->getNext();
-            }
+    int CurrentTimeStep = 1;
+    while (CurrentTimeStep >= 0)
+    {
+        SimulateTimeStep(CurrentTimeStep);
 
-            CurrentTimeStep++;
+        if (monitor && --untilCheck == 0)
+        {
+            untilCheck = MonitorInterval;
+            if (!monitor->KeepRunning(*this, CurrentTimeStep))
+                return false;
         }
 
-        // Write output file
-        WriteOutputFile("output.txt");
-        
-        pGUI->PrintMessage("Simulation Finished Successfully!");
-        if (mode != MODE_SLNT)
-            pGUI->waitForClick();
+        // Nobody reads the order lines: drop finished orders right away
+        while (!finished.isEmpty())
+        {
+            orderPool.release(finished.getHead()->getItem());
+            finished.DeleteFirst();
+        }
+
+        if (!HasPendingWork())
+            break;
+        CurrentTimeStep = AdvanceTime(CurrentTimeStep, true);
     }
+    return !streamFailed;
 }
-void Restaurant::LoadInputFile(const string& filename)
+
+SimSummary Restaurant::getSummary() const
 {
-    ifstream file(filename);
-    if (!file.is_open())
-    {
-        if (pGUI) pGUI->PrintMessage("ERROR: Cannot open file: " + filename);
+    SimSummary summary;
+    summary.finishedOrders = CountFinished;
+    summary.avgWait = (CountFinished > 0) ? (double)TotalWaitTime / CountFinished : 0.0;
+    summary.avgServ = (CountFinished > 0) ? (double)TotalServTime / CountFinished : 0.0;
+    summary.lateOrders = lateOrderCount;
+    summary.pendingOrders = arrivedCount - CountFinished - cancelledCount;
+    summary.autoPromoted = autoPromotedCount;
+    summary.totalWait = TotalWaitTime;
+    summary.events = executedEvents;
+    summary.simulatedSteps = simulatedSteps;
+    summary.lastTimeStep = lastTimeStep;
+    return summary;
+}
+
+void Restaurant::setObserver(SimObserver* pObs)
+{
+    pObserver = pObs;
+}
+
+void Restaurant::setPhaseProfile(PhaseProfile* profile)
+{
+    phaseProfile = profile;
+}
+
+void Restaurant::setMemoryReport(bool enabled)
+{
+    memoryReport = enabled;
+}
+
+void Restaurant::setMemorySamples(std::ostream* out, int interval)
+{
+    memorySamples = out;
+    memorySampleInterval = (interval > 0) ? interval : 1;
+    nextMemorySample = 0;
+    if (!out)
         return;
+
+    OutputBuffer header;
+    header.append("time");
+    for (int t = 0; t < ALLOC_TAG_CNT; t++)
+    {
+        const char* name = AllocTracker::TagName((ALLOC_TAG)t);
+        const char* columns[] = { "_live", "_peak", "_allocs", "_frees" };
+        for (const char* column : columns)
+        {
+            header.append(',');
+            header.append(name);
+            header.append(column);
+        }
     }
-	// Read restaurant parameters N is number of cooks of each type , G is the number of vegan cooks , V is the number of VIP cooks
-	// SN, SG, SV are the speed of normal , vegan , VIP cooks respectively
-	// BO, BN, BG, BV are the break times for each type of cooks
-	// M is the number of events
-    int N, G, V, SN, SG, SV, BO, BN, BG, BV, M;
-    file >> N >> G >> V;
-    file >> SN >> SG >> SV;
-    file >> BO >> BN >> BG >> BV;
-    file >> AutoP;  // Auto-promotion limit
-    
-    // Create Normal cooks
-    for (int i = 1; i <= N; i++)
+    header.append('\n');
+    header.writeTo(*out);
+}
+
+const string& Restaurant::getLastError() const
+{
+    return lastError;
+}
+
+// Errors are kept for headless callers and shown by the observer (if any)
+void Restaurant::ReportError(const string& msg)
+{
+    lastError = msg;
+    if (pObserver)
+        pObserver->PrintMessage("ERROR: " + msg);
+}
+
+bool Restaurant::LoadInputFile(const string& filename)
+{
+    if (RTraceFile::isRTrace(filename))
+        return LoadBinaryTrace(filename);
+
+    TraceParser* parser = new TraceParser;
+    if (!parser->open(filename))
     {
-        Cook* newCook = new Cook(i, COOK_NRM, SN, BO, BN);
-        normalCooks.InsertEnd(newCook);
+        delete parser;
+        ReportError("Cannot open file: " + filename);
+        return false;
     }
-    
-    // Create Vegan cooks
-    for (int i = 1; i <= G; i++)
+
+    TraceHeader header;
+    if (!parser->readHeader(header))
     {
-        Cook* newCook = new Cook(i, COOK_VGAN, SG, BO, BG);
-        veganCooks.InsertEnd(newCook);
+        ReportError(parser->getError());
+        delete parser;
+        return false;
     }
-    
-    // Create VIP cooks
-    for (int i = 1; i <= V; i++)
+    Configure(header);
+
+    // Streaming: events are read by ExecuteEvents as time reaches them
+    if (streamEvents)
     {
-        Cook* newCook = new Cook(i, COOK_VIP, SV, BO, BV);
-        vipCooks.InsertEnd(newCook);
+        parser->setRequireSorted(true);
+        eventStream = parser;
+        streamedUpTo = 0;
+        if (pObserver)
+            pObserver->PrintMessage("Streaming " + to_string(header.M) + " events. Starting simulation...");
+        return true;
     }
-    
-    // Read number of events
-    file >> M;
-  
 
-    for (int i = 0; i < M; i++)
+    EventRecord rec;
+    while (parser->next(rec))
+        Events.insert(MakeEvent(rec));
+    bool ok = !parser->hasError();
+    if (!ok)
+        ReportError(parser->getError());
+    delete parser;
+    if (!ok)
+        return false;
+
+    if (pObserver)
+        pObserver->PrintMessage("Loaded " + to_string(Events.getSize()) + " events. Starting simulation...");
+    return true;
+}
+
+// Maps an .rtrace file; its records are executed in place by ExecuteEvents
+bool Restaurant::LoadBinaryTrace(const string& filename)
+{
+    RTraceFile* trace = new RTraceFile;
+    if (!trace->open(filename))
     {
-        char eventType;
-        file >> eventType;
+        ReportError(trace->getError());
+        delete trace;
+        return false;
+    }
 
-        if (eventType == 'R')
-        {
-            char typ; int ts, id, size; double money;
-            file >> typ >> ts >> id >> size >> money;
-            ORD_TYPE type = (typ == 'N') ? TYPE_NRM : (typ == 'G') ? TYPE_VGAN : TYPE_VIP;
-            Event* evt = new ArrivalEvent(ts, id, type, size, money);
-            Events.InsertEnd(evt);
-        }
-        else if (eventType == 'X')
-        {
-            int ts, id;
-            file >> ts >> id;
-            Event* evt = new CancellationEvent(ts, id);
-            Events.InsertEnd(evt);
-        }
-        else if (eventType == 'P')
-        {
-            int ts, id, extra;
-            file >> ts >> id >> extra;
-            Event* evt = new PromotionEvent(ts, id, extra);
-            Events.InsertEnd(evt);
-        }
+    Configure(trace->getHeader());
+
+    binaryTrace = trace;
+    nextRecord = trace->begin();
+
+    if (pObserver)
+        pObserver->PrintMessage("Mapped " + to_string(trace->getCount()) + " events. Starting simulation...");
+    return true;
+}
+
+bool Restaurant::LoadTrace(const EventTrace& trace, const TraceHeader& header)
+{
+    Configure(header);
+    sharedTrace = &trace;
+    traceCursor = EventTrace::Start();
+    return true;
+}
+
+void Restaurant::Configure(const TraceHeader& header)
+{
+    AutoP = header.AutoP;
+    promotionWheel.reset(AutoP + 1);
+    CreateCooks(header);
+    RegisterCookPools();
+}
+
+int Restaurant::CloseTimeStep(int currentTime)
+{
+    UpdateCookStatuses(currentTime);
+    return NextStateChangeTime(currentTime);
+}
+
+// Complexity: O(1)
+BranchLoad Restaurant::getLoad() const
+{
+    BranchLoad load;
+    load.servingOrders = inService.getSize();
+    load.waitingOrders = orderIndex.getSize() - load.servingOrders;
+    load.freeCooks = 0;
+    load.cooks = 0;
+    for (int i = 0; i < COOK_CNT; i++)
+    {
+        load.freeCooks += freeCooks[i].getFreeCount();
+        load.cooks += freeCooks[i].getSize();
     }
-    pGUI->PrintMessage("Loaded " + to_string(Events.countNodes()) + " events. Starting simulation...");
+    load.avgServ = (CountFinished > 0) ? (double)TotalServTime / CountFinished : 0.0;
+    return load;
+}
 
-    file.close();
+// N normal, G vegan and V VIP cooks, IDs 1..count within each type
+void Restaurant::CreateCooks(const TraceHeader& h)
+{
+    for (int i = 1; i <= h.N; i++)
+    {
+        Cook* newCook = new Cook(i, COOK_NRM, h.SN, h.BO, h.BN, &cookTable);
+        normalCooks.InsertEnd(newCook);
+    }
+
+    for (int i = 1; i <= h.G; i++)
+    {
+        Cook* newCook = new Cook(i, COOK_VGAN, h.SG, h.BO, h.BG, &cookTable);
+        veganCooks.InsertEnd(newCook);
+    }
+
+    for (int i = 1; i <= h.V; i++)
+    {
+        Cook* newCook = new Cook(i, COOK_VIP, h.SV, h.BO, h.BV, &cookTable);
+        vipCooks.InsertEnd(newCook);
+    }
 }
 
 //for bonus 1:
@@ -298,7 +519,7 @@ void Restaurant::LoadInputFile(const string& filename)
     ifstream file(filename);
     if (!file.is_open())
     {
-        if (pGUI) pGUI->PrintMessage("ERROR: Cannot open file: " + filename);
+        if (pObserver) pObserver->PrintMessage("ERROR: Cannot open file: " + filename);
         return;
     }
 
@@ -348,6 +569,7 @@ void Restaurant::LoadInputFile(const string& filename)
     sortCooksBySpeed(normalCooks);
     sortCooksBySpeed(veganCooks);
     sortCooksBySpeed(vipCooks);
+    RegisterCookPools();
 
     // Read auto-promotion limit
     file >> AutoP;
@@ -367,21 +589,21 @@ void Restaurant::LoadInputFile(const string& filename)
             file >> typ >> ts >> id >> size >> money;
             ORD_TYPE type = (typ == 'N') ? TYPE_NRM : (typ == 'G') ? TYPE_VGAN : TYPE_VIP;
             Event* evt = new ArrivalEvent(ts, id, type, size, money);
-            Events.InsertEnd(evt);
+            Events.insert(evt);
         }
         else if (eventType == 'X')
         {
             int ts, id;
             file >> ts >> id;
             Event* evt = new CancellationEvent(ts, id);
-            Events.InsertEnd(evt);
+            Events.insert(evt);
         }
         else if (eventType == 'P')
         {
             int ts, id, extra;
             file >> ts >> id >> extra;
             Event* evt = new PromotionEvent(ts, id, extra);
-            Events.InsertEnd(evt);
+            Events.insert(evt);
         }
     }
 
@@ -389,147 +611,153 @@ void Restaurant::LoadInputFile(const string& filename)
 }
 */
 
-void Restaurant::ExecuteEvents(int CurrentTimeStep)
+// Streaming mode: reads ahead until every event due by currentTime and the
+// first later one are in Events (NextStateChangeTime and HasPendingWork look
+// at that one), keeping up to StreamWindow events buffered between reads
+void Restaurant::StreamEvents(int currentTime)
 {
-    Node<Event*>* curr = Events.getHead();
-    while (curr)
+    EventRecord rec;
+    while (eventStream && (streamedUpTo <= currentTime || Events.getSize() < StreamWindow))
     {
-        Event* e = curr->getItem();
-        if (e->getEventTime() == CurrentTimeStep)
+        if (!eventStream->next(rec))
         {
-            e->Execute(this);
-            Node<Event*>* toDelete = curr;
-            curr = curr->getNext();
-            Events.DeleteNodeByPointer(toDelete);
-        }
-        else
-        {
-            curr = curr->getNext();
+            if (eventStream->hasError())
+            {
+                ReportError(eventStream->getError());
+                streamFailed = true;
+            }
+            delete eventStream;
+            eventStream = nullptr;
+            return;
         }
+        Events.insert(MakeEvent(rec));
+        streamedUpTo = rec.time;
     }
 }
 
-void Restaurant::MoveOneFromEachWaitToInService()
+// Timestep of the next pending event (-1 if none)
+int Restaurant::NextEventTime()
 {
-    if (!waitNormal.isEmpty())
-    {
-        Order* o = waitNormal.getHead()->getItem();
-        o->setStatus(SRV);
-        inService.InsertEnd(o);
-        waitNormal.DeleteFirst();
-    }
-    if (!waitVegan.isEmpty())
+    if (sharedTrace)
+        return sharedTrace->nextTime(traceCursor);
+    if (binaryTrace)
+        return (nextRecord != binaryTrace->end()) ? nextRecord->time : -1;
+    return Events.nextEventTime();
+}
+
+// Pops only the events that are due at this timestep
+// Complexity: O(k log E) where k = number of due events
+void Restaurant::ExecuteEvents(int CurrentTimeStep)
+{
+    PHASE_TIMER(phaseProfile, PHASE_EVENTS);
+    // Traces and .rtrace records are sorted like the calendar would order them
+    if (sharedTrace)
     {
-        Order* o = waitVegan.peek();
-        o->setStatus(SRV);
-        inService.InsertEnd(o);
-        waitVegan.dequeue();
+        EventRecord rec;
+        int t;
+        while ((t = sharedTrace->nextTime(traceCursor)) >= 0 && t <= CurrentTimeStep)
+        {
+            sharedTrace->take(traceCursor, rec);
+            ExecuteEvent(rec, this);
+            executedEvents++;
+        }
+        return;
     }
-    if (!waitVIP.isEmpty())
+    if (binaryTrace)
     {
-        Order* o; int p;
-        waitVIP.peek(o, p);
-        o->setStatus(SRV);
-        inService.InsertEnd(o);
-        waitVIP.dequeue(o, p);  // Pass arguments for dequeue
+        EventRecord rec;
+        const RTraceRecord* last = binaryTrace->end();
+        while (nextRecord != last && nextRecord->time <= CurrentTimeStep)
+        {
+            ToEventRecord(*nextRecord++, rec);
+            ExecuteEvent(rec, this);
+            executedEvents++;
+        }
+        binaryTrace->release(nextRecord);
+        return;
     }
 
-}
-// Move one order from in-service to finished
-void Restaurant::MoveOneFromInServiceToFinished()
-{
-    if (!inService.isEmpty())
+    StreamEvents(CurrentTimeStep);
+
+    Event* e;
+    while (Events.popDue(CurrentTimeStep, e))
     {
-        Order* o = inService.getHead()->getItem();
-        o->setStatus(DONE);
-        finished.InsertEnd(o);
-        inService.DeleteFirst();
+        e->Execute(this);
+        delete e;
+        executedEvents++;
     }
 }
+
 // Callbacks from Events
+Order* Restaurant::CreateOrder(int id, ORD_TYPE type)
+{
+    arrivedCount++;
+    return orderPool.create(id, type);
+}
+
 void Restaurant::AddToWaitingList(Order* pOrd)
 {
     switch (pOrd->GetType())
     {
-    case TYPE_NRM: waitNormal.InsertEnd(pOrd); break;
-    case TYPE_VGAN: waitVegan.enqueue(pOrd); break;
-    case TYPE_VIP: 
-        double priority = pOrd->calculateVIPPriority();
-        waitVIP.enqueue(pOrd, (int)priority); 
+    case TYPE_NRM:
+        pOrd->setWaitNode(waitNormal.InsertEnd(pOrd));
+        orderIndex.insert(pOrd, LOC_WAIT_NRM);
+        SchedulePromotion(pOrd, pOrd->GetArrTime());     // arrives now
+        break;
+    case TYPE_VGAN:
+        waitVegan.enqueue(pOrd);
+        orderIndex.insert(pOrd, LOC_WAIT_VGAN);
+        break;
+    case TYPE_VIP:
+        AddVIPOrder(pOrd, pOrd->calculateVIPPriority());
         break;
     }
 }
-// Cancel order by ID
+
+// Cancel order by ID (only waiting Normal orders can be cancelled)
+// Complexity: O(1)
 void Restaurant::CancelOrder(int orderID)
 {
-    Node<Order*>* curr = waitNormal.getHead();
-    while (curr)
-    {
-        if (curr->getItem()->GetID() == orderID)
-        {
-            waitNormal.DeleteNodeByPointer(curr);
-            return;
-        }
-        curr = curr->getNext();
-    }
+    OrderIndex::Entry* entry = orderIndex.find(orderID);
+    if (!entry || entry->location != LOC_WAIT_NRM)
+        return;
+
+    Order* order = entry->order;
+    RemoveFromNormalList(order);
+    CancelPromotion(order);
+    orderIndex.erase(order);
+    orderPool.release(order);
+    cancelledCount++;
 }
 
 // Promote Normal order to VIP by ID
-// Complexity: O(W_N) where W_N = number of waiting Normal orders
+// Complexity: O(log W_VIP) for the VIP enqueue, the lookup is O(1)
 void Restaurant::PromoteOrder(int orderID, int extraMoney)
 {
-    Node<Order*>* curr = waitNormal.getHead();
-    while (curr)
-    {
-        Order* order = curr->getItem();
-        if (order->GetID() == orderID)
-        {
-            // Remove from Normal waiting list
-            waitNormal.DeleteNodeByPointer(curr);
-            
-            // Add extra money to order
-            order->setTotalMoney(order->getTotalMoney() + extraMoney);
-            
-            // Convert to VIP type
-            order->setType(TYPE_VIP);
-            
-            // Calculate VIP priority and add to VIP queue
-            double priority = order->calculateVIPPriority();
-            waitVIP.enqueue(order, (int)priority);
-            
-            if (pGUI)
-            {
-                pGUI->PrintMessage("Promoted Order " + to_string(orderID) + " to VIP");
-            }
-            
-            return;
-        }
-        curr = curr->getNext();
-    }
-}
-
-// GUI support 
-void Restaurant::FillDrawingList()
-{
-    pGUI->ResetDrawingList();
+    OrderIndex::Entry* entry = orderIndex.find(orderID);
+    if (!entry || entry->location != LOC_WAIT_NRM)
+        return;
 
-    Node<Order*>* p;
+    Order* order = entry->order;
 
-    p = waitNormal.getHead(); while (p) { pGUI->AddToDrawingList(p->getItem()); p = p->getNext(); }
-    p = waitVegan.getHead();  while (p) { pGUI->AddToDrawingList(p->getItem()); p = p->getNext(); }
-    // For priQueue, we cannot access nodes directly. Use getItem(i, ref)
-    for (int i = 0; i < waitVIP.getSize(); i++) {
-        Order* ord;
-        if (waitVIP.getItem(i, ord))
-            pGUI->AddToDrawingList(ord);
-    }
+    // Remove from Normal waiting list
+    RemoveFromNormalList(order);
+    CancelPromotion(order);
 
-    p = inService.getHead();  while (p) { pGUI->AddToDrawingList(p->getItem()); p = p->getNext(); }
-    p = finished.getHead();   while (p) { pGUI->AddToDrawingList(p->getItem()); p = p->getNext(); }
+    // Add extra money to order
+    order->setTotalMoney(order->getTotalMoney() + extraMoney);
 
-    // مفيش Cooks في Phase 1 خالص
+    // Convert to VIP type
+    order->setType(TYPE_VIP);
 
+    // Calculate VIP priority and add to VIP queue
+    double priority = order->calculateVIPPriority();
+    AddVIPOrder(order, priority);
 
+    if (pObserver)
+    {
+        pObserver->PrintMessage("Promoted Order " + to_string(orderID) + " to VIP");
+    }
 }
 
 //========================================
@@ -538,84 +766,31 @@ void Restaurant::FillDrawingList()
 
 void Restaurant::AssignVIPOrders(int currentTime)
 {
-    // Complexity: O(V + N + G) -> done once, not per order
-
-    LinkedList<Cook*> availableVIP;
-    LinkedList<Cook*> availableNormal;
-    LinkedList<Cook*> availableVegan;
-
-    // Scan VIP cooks
-    Node<Cook*>* curr = vipCooks.getHead();
-
-    while (curr)
-    {
-		//this whole loop is just because insertend acceps reference to pointer not pointer itself
-        if (curr->getItem()->isAvailable())
-        {
-            Cook* VIPCookPtr = curr->getItem();
-            availableVIP.InsertEnd(VIPCookPtr);
-        }
-        curr = curr->getNext();
-    }
-
-    // Scan Normal cooks
-    curr = normalCooks.getHead();
-    while (curr)
-    {
-        if (curr->getItem()->isAvailable())
-        {
-            Cook* NormalCookPtr = curr->getItem();
-            availableNormal.InsertEnd(NormalCookPtr);
-        }
-        curr = curr->getNext();
-    }
-
-    // Scan Vegan cooks
-    curr = veganCooks.getHead();
-    while (curr)
-    {
-        if (curr->getItem()->isAvailable())
-        {
-            Cook* veganCookPtr = curr->getItem();
-            availableVegan.InsertEnd(veganCookPtr);
-        }
-        curr = curr->getNext();
-    }
-
-    // Process VIP orders using pre-built lists
+    PHASE_TIMER(phaseProfile, PHASE_ASSIGN_VIP);
     // Complexity: O(VP × log VP) -> VP = VIP orders processed
+    // Picking a cook is O(1) per order and nothing is allocated
+    waitVIP.advanceTo(currentTime);     // aging: O(log W) per order changing segment
     while (!waitVIP.isEmpty())
     {
         Order* vipOrder;
-        int priority;
+        double priority;
 
         if (!waitVIP.peek(vipOrder, priority))
             break;
 
-        Cook* assignedCook = nullptr;
-
-        // Try to get cook from available lists (O(1) each)
-        if (!availableVIP.isEmpty())
-        {
-            assignedCook = availableVIP.GetHead();
-            availableVIP.DeleteFirst();
-        }
-        else if (!availableNormal.isEmpty())
-        {
-            assignedCook = availableNormal.GetHead();
-            availableNormal.DeleteFirst();
-        }
-        else if (!availableVegan.isEmpty())
-        {
-            assignedCook = availableVegan.GetHead();
-            availableVegan.DeleteFirst();
-        }
+        // VIP cooks first, then Normal, then Vegan
+        // (VIP orders go to the last available cook of the list, as always) - O(1)
+        Cook* assignedCook = freeCooks[COOK_VIP].last();
+        if (!assignedCook)
+            assignedCook = freeCooks[COOK_NRM].last();
+        if (!assignedCook)
+            assignedCook = freeCooks[COOK_VGAN].last();
 
         // Only attempt preemption if no available cooks
         // and we have waiting VIP orders that need service
         if (!assignedCook)
         {
-            // Preemption: O(N) but only when necessary
+            // Preemption: O(log C) but only when necessary
             Order* preemptedOrder = findNormalOrderToPreempt(currentTime);
             if (preemptedOrder)
             {
@@ -631,11 +806,7 @@ void Restaurant::AssignVIPOrders(int currentTime)
         if (assignedCook)
         {
             waitVIP.dequeue(vipOrder, priority);  // O(log W)
-            assignedCook->assignOrder(vipOrder, currentTime);
-
-            // Update statistics
-            int waitTime = currentTime - vipOrder->GetArrTime();
-            TotalWaitTime += waitTime;
+            StartService(assignedCook, vipOrder, currentTime);
         }
         else
         {
@@ -648,96 +819,60 @@ void Restaurant::AssignVIPOrders(int currentTime)
 
 
 // Helper: Find available cook of specific type
-// Complexity: O(n) where n = number of cooks of that type
+// Complexity: O(1) (find-first-set on the type's free-cook pool)
 Cook* Restaurant::findAvailableCook(COOK_TYPE type)
 {
-    LinkedList<Cook*>* cookList = nullptr;
+    if (type < 0 || type >= COOK_CNT) return nullptr;
 
-    switch (type)
-    {
-    case COOK_VIP:  cookList = &vipCooks; break;
-    case COOK_NRM:  cookList = &normalCooks; break;
-    case COOK_VGAN: cookList = &veganCooks; break;
-    }
+    return freeCooks[type].first();  // nullptr if no available cook of this type
+}
 
-    if (!cookList) return nullptr;
+// Gives every cook a slot in its type's free-cook pool, in list order
+// Must run once after the cook lists are final (loaded and sorted)
+void Restaurant::RegisterCookPools()
+{
+    LinkedList<Cook*>* allLists[] = { &normalCooks, &veganCooks, &vipCooks };
+    COOK_TYPE listTypes[] = { COOK_NRM, COOK_VGAN, COOK_VIP };
 
-    Node<Cook*>* current = cookList->getHead();
-    while (current)
+    for (int i = 0; i < 3; i++)
     {
-        Cook* cook = current->getItem();
-        if (cook->isAvailable())
-            return cook;
-
-        current = current->getNext();
+        CookPool& pool = freeCooks[listTypes[i]];
+        Node<Cook*>* cookNode = allLists[i]->getHead();
+        while (cookNode)
+        {
+            Cook* cook = cookNode->getItem();
+            cook->setPool(&pool, pool.add(cook));
+            cookNode = cookNode->getNext();
+        }
     }
-
-    return nullptr;  // No available cook of this type
 }
 
 // Find Normal order to preempt (choose least negative impact)
-// Complexity: O(n) where n = number of busy Normal cooks
-Order* Restaurant::findNormalOrderToPreempt(int currentTime)
+// The Normal order on a Normal cook with the least service time so far,
+// ties go to the cook listed first
+// Complexity: O(1) (the index is maintained in O(log C) per assignment)
+Order* Restaurant::findNormalOrderToPreempt(int)
 {
-    Order* bestToPreempt = nullptr;
-    int leastServiceTime = INT_MAX;
-
-    // Check all busy Normal cooks
-    Node<Cook*>* current = normalCooks.getHead();
-    while (current)
-    {
-        Cook* cook = current->getItem();
-
-        // Only consider busy cooks serving Normal orders
-        if (cook->isBusy())
-        {
-            Order* currentOrder = cook->getCurrentOrder();
-            if (currentOrder && currentOrder->GetType() == TYPE_NRM)
-            {
-                // Calculate how much service time has been spent
-                int startTime = currentOrder->GetServTime();
-                int serviceTimeSoFar = currentTime - startTime;
-                if (serviceTimeSoFar < 0) serviceTimeSoFar = 0;
-
-                // Preempt the order with least service time (least waste)
-                if (serviceTimeSoFar < leastServiceTime)
-                {
-                    leastServiceTime = serviceTimeSoFar;
-                    bestToPreempt = currentOrder;
-                }
-            }
-        }
+    Cook* cook;
+    PreemptKey key;
 
-        current = current->getNext();
-    }
+    if (!preemptible.peek(cook, key))
+        return nullptr;
 
-    return bestToPreempt;
+    return cook->getCurrentOrder();
 }
 
 // Find which cook is serving a specific order
-// Complexity: O(total_cooks)
+// Complexity: O(1) (back-pointer set by Cook::assignOrder)
 Cook* Restaurant::findCookServingOrder(Order* order)
 {
-    // Check all cook lists
-    LinkedList<Cook*>* allLists[] = { &normalCooks, &veganCooks, &vipCooks };
-
-    for (int i = 0; i < 3; i++)
-    {
-        Node<Cook*>* current = allLists[i]->getHead();
-        while (current)
-        {
-            Cook* cook = current->getItem();
-            if (cook->getCurrentOrder() == order)
-                return cook;
+    if (!order || order->getStatus() != SRV)
+        return nullptr;
 
-            current = current->getNext();
-        }
-    }
-
-    return nullptr;
+    return order->getCook();
 }
 
-// Complexity: O(1)
+// Complexity: O(log B)
 void Restaurant::preemptOrder(Cook* cook, Order* order, int currentTime)
 {
     // Calculate remaining dishes
@@ -762,16 +897,23 @@ void Restaurant::preemptOrder(Cook* cook, Order* order, int currentTime)
     // Update order size to remaining dishes
     order->setOrderSize(remainingDishes);
 
-    // Remove order from cook
+    // Remove order from cook and drop its pending completion - O(log B)
+    inService.erase(order->getServiceHandle());
+    order->setServiceHandle(-1);
+    preemptible.erase(order->getPreemptHandle());
+    order->setPreemptHandle(-1);
+    order->setCook(nullptr);
     cook->finishCurrentOrder();  // This frees the cook
 
     // Return order to Normal waiting list with ORIGINAL arrival time
-    waitNormal.InsertEnd(order);
+    order->setWaitNode(waitNormal.InsertEnd(order));
+    orderIndex.insert(order, LOC_WAIT_NRM);
+    SchedulePromotion(order, currentTime);
     order->setStatus(WAIT);
 
-    if (pGUI)
+    if (pObserver)
     {
-        pGUI->PrintMessage("Preempted Order " + to_string(order->GetID()) +
+        pObserver->PrintMessage("Preempted Order " + to_string(order->GetID()) +
             ". Completed " + to_string(dishesCompleted) + " dishes.");
     }
 
@@ -780,6 +922,7 @@ void Restaurant::preemptOrder(Cook* cook, Order* order, int currentTime)
 
 void Restaurant::AssignNormalOrders(int currentTime)
 {
+    PHASE_TIMER(phaseProfile, PHASE_ASSIGN_NORMAL);
     // Continue assigning while we have waiting Normal orders
     while (!waitNormal.isEmpty())
     {
@@ -793,12 +936,10 @@ void Restaurant::AssignNormalOrders(int currentTime)
 
         Cook* assignedCook = nullptr;
 
-        // Try Normal cooks first
-        // Complexity: O(N)،،،، N = number of Normal cooks
+        // Try Normal cooks first - O(1)
         assignedCook = findAvailableCook(COOK_NRM);
 
-        // If no Normal cook available, try VIP cooks
-        // Complexity: O(V) where V = number of VIP cooks
+        // If no Normal cook available, try VIP cooks - O(1)
         if (!assignedCook)
             assignedCook = findAvailableCook(COOK_VIP);
 
@@ -807,17 +948,12 @@ void Restaurant::AssignNormalOrders(int currentTime)
         {
             // Remove from waiting list - O(1)
             waitNormal.DeleteFirst();
+            normalOrder->setWaitNode(nullptr);
+            CancelPromotion(normalOrder);
 
             // Assign order to cook - O(1)
-            assignedCook->assignOrder(normalOrder, currentTime);
-
-            // Calculate and store waiting time
-            int waitTime = currentTime - normalOrder->GetArrTime();
-            // You can store this in the order or accumulate statistics
+            StartService(assignedCook, normalOrder, currentTime);
             normalOrder->setServTime(currentTime);
-
-            // Update statistics (in case)
-            TotalWaitTime += waitTime;
         }
         else
         {
@@ -832,6 +968,7 @@ void Restaurant::AssignNormalOrders(int currentTime)
 
 void Restaurant::AssignVeganOrders(int currentTime)
 {
+    PHASE_TIMER(phaseProfile, PHASE_ASSIGN_VEGAN);
     while (!waitVegan.isEmpty())
     {
         Order* veganOrder = waitVegan.peek();
@@ -840,9 +977,7 @@ void Restaurant::AssignVeganOrders(int currentTime)
         if (assignedCook)
         {
             waitVegan.dequeue();
-            assignedCook->assignOrder(veganOrder, currentTime);
-            int waitTime = currentTime - veganOrder->GetArrTime();
-            TotalWaitTime += waitTime;
+            StartService(assignedCook, veganOrder, currentTime);
         }
         else
         {
@@ -851,68 +986,116 @@ void Restaurant::AssignVeganOrders(int currentTime)
     }
 }
 
+// Every waiting Normal order has a timer on promotionWheel for the timestep
+// its waiting time passes AutoP, so only the orders due now are touched
+// (waitNormal is newest-first and preempted orders go back in with their
+// old arrival time, so the list order says nothing about who is due)
+// Complexity: O(1) per timestep passed + O(log W_VIP) per promoted order
 void Restaurant::CheckAutoPromotionOptimized(int currentTime)
 {
-    //  Keep track of oldest Normal order's arrival time
-    // If oldest hasn't exceeded limit, none have
+    PHASE_TIMER(phaseProfile, PHASE_AUTO_PROMOTION);
+    promotionWheel.advanceTo(currentTime, [this](Order* order) {
+        AutoPromote(order);
+    });
+}
 
-    if (waitNormal.isEmpty())
-        return;
+// Timer callback: moves a Normal order that waited too long to the VIP queue
+// The order becomes VIP like a promoted one, so it is never preempted (and
+// re-promoted) again
+// Complexity: O(log W_VIP), the order knows its list node
+void Restaurant::AutoPromote(Order* order)
+{
+    order->setPromoteTimer(-1);
+    RemoveFromNormalList(order);
 
-    // Peek at oldest order
-    Node<Order*>* oldestNode = waitNormal.getHead();
-    Order* oldestOrder = oldestNode->getItem();
+    // Convert to VIP type and add to VIP queue
+    order->setType(TYPE_VIP);
+    double priority = order->calculateVIPPriority();
+    AddVIPOrder(order, priority);
 
-    // Check oldest order first - O(1)
-    int oldestWaitTime = currentTime - oldestOrder->GetArrTime();
+    autoPromotedCount++;
 
-    if (oldestWaitTime <= AutoP)
+    if (pObserver)
     {
-        // If oldest hasn't exceeded limit, none have
-        return;
+        pObserver->PrintMessage("Auto-promoted Order " +
+            to_string(order->GetID()));
     }
+}
 
-    // If we reach here, at least one order needs promotion
-    // Scan and promote all that exceed limit - O(W_N)
-    Node<Order*>* curr = waitNormal.getHead();
+// Registers a waiting Normal order for auto-promotion once it waited more
+// than AutoP timesteps (at the next timestep if that is already past)
+void Restaurant::SchedulePromotion(Order* order, int currentTime)
+{
+    int due = order->GetArrTime() + AutoP + 1;
+    if (due <= currentTime) due = currentTime + 1;
+    order->setPromoteTimer(promotionWheel.schedule(order, due));
+}
 
-    while (curr)
-    {
-        Order* order = curr->getItem();
-        int waitingTime = currentTime - order->GetArrTime();
+// Complexity: O(1)
+void Restaurant::RemoveFromNormalList(Order* order)
+{
+    assert(order->getWaitNode() && order->getWaitNode()->getItem() == order);
+    waitNormal.DeleteNodeByPointer(order->getWaitNode());
+    order->setWaitNode(nullptr);
+}
 
-        if (waitingTime > AutoP)
-        {
-            // This order needs promotion
-            Node<Order*>* toPromote = curr;
-            curr = curr->getNext();  // Move to next before deletion
+void Restaurant::CancelPromotion(Order* order)
+{
+    promotionWheel.cancel(order->getPromoteTimer());
+    order->setPromoteTimer(-1);
+}
 
-            // Remove from Normal list
-            Order* promotedOrder = toPromote->getItem();
-            waitNormal.DeleteNodeByPointer(toPromote);
+// Earliest timestep after currentTime at which any phase of the loop can
+// change the state (must be called after the cook status update)
+// Candidates: next event, next auto-promotion, next order completion,
+// next break end / injury recovery. Every timestep in between is a no-op
+// except for the per-cook statistics, which BillSkippedTimeSteps covers.
+// Returns -1 if nothing can ever change again.
+// Complexity: O(C) for the break/injury scan, the rest is O(1)
+int Restaurant::NextStateChangeTime(int currentTime)
+{
+    int earliest = currentTime + 1;
 
-            // Add to VIP queue
-            double priority = promotedOrder->calculateVIPPriority();
-            waitVIP.enqueue(promotedOrder, (int)priority);
+    // A cook freed by the status update can serve a waiting order right away
+    if ((!waitVIP.isEmpty() && (findAvailableCook(COOK_VIP) || findAvailableCook(COOK_NRM) || findAvailableCook(COOK_VGAN))) ||
+        (!waitNormal.isEmpty() && (findAvailableCook(COOK_NRM) || findAvailableCook(COOK_VIP))) ||
+        (!waitVegan.isEmpty() && findAvailableCook(COOK_VGAN)))
+        return earliest;
 
-            autoPromotedCount++;
+    int nextTime = INT_MAX;
 
-            if (pGUI)
-            {
-                pGUI->PrintMessage("Auto-promoted Order " +
-                    to_string(promotedOrder->GetID()));
-            }
-        }
-        else
-        {
-            //If the oldest person in the line hasn't waited long enough to be promoted yet, 
-            //then the people behind them definitely haven't waited long enough either.
-            break;
-        }
+    // Next event - O(1)
+    int eventTime = NextEventTime();
+    if (eventTime >= 0)
+        nextTime = eventTime;
 
-    }
+    // Next auto-promotion - O(AutoP / 64) at worst, next non-empty wheel slot
+    int promoteTime = promotionWheel.nextFireTime();
+    if (promoteTime >= 0 && promoteTime < nextTime)
+        nextTime = promoteTime;
 
+    // Next order completion - O(1)
+    Order* ord;
+    int finishTime;
+    if (inService.peek(ord, finishTime) && finishTime < nextTime)
+        nextTime = finishTime;
 
+    // Next break end / injury recovery - O(C), one pass over the cook table
+    int endTime = cookTable.nextEndTime();
+    if (endTime >= 0 && endTime < nextTime)
+        nextTime = endTime;
+
+    if (nextTime == INT_MAX)
+        return -1;
+
+    return (nextTime < earliest) ? earliest : nextTime;
+}
+
+// Bills the skipped timesteps to every cook's busy/idle/break counter
+// Complexity: O(C) for the whole interval
+void Restaurant::BillSkippedTimeSteps(int skipped)
+{
+    cookTable.accountTime(skipped);
 }
 
 //for bonus 1:
@@ -993,18 +1176,122 @@ void Restaurant::mergeCooks(Cook** arr, int left, int mid, int right)
     delete[] R;
 }
 
+// Stable sort of the orders on (FT, ST)
+// LSD radix sort, 16 bits per pass; a pass whose digit is the same for every
+// order is skipped, so most runs need 2-3 passes. Small batches (the per-step
+// flushes of streaming mode) use insertion sort instead.
+// Complexity: O(N)
+static void SortByFinishThenService(Order** orders, int n)
+{
+    if (n < 64)
+    {
+        for (int i = 1; i < n; i++)
+        {
+            Order* moving = orders[i];
+            int ft = moving->GetFinishTime(), st = moving->GetServTime();
+            int j = i - 1;
+            while (j >= 0 && (orders[j]->GetFinishTime() > ft ||
+                   (orders[j]->GetFinishTime() == ft && orders[j]->GetServTime() > st)))
+            {
+                orders[j + 1] = orders[j];
+                j--;
+            }
+            orders[j + 1] = moving;
+        }
+        return;
+    }
+
+    // Flipping the sign bit makes the unsigned order match the signed one
+    unsigned long long* keys = new unsigned long long[n];
+    unsigned long long* keysTmp = new unsigned long long[n];
+    Order** ordersTmp = new Order*[n];
+    int* bucket = new int[1 << 16];
+    for (int i = 0; i < n; i++)
+    {
+        unsigned int ft = (unsigned int)orders[i]->GetFinishTime() ^ 0x80000000u;
+        unsigned int st = (unsigned int)orders[i]->GetServTime() ^ 0x80000000u;
+        keys[i] = ((unsigned long long)ft << 32) | st;
+    }
+
+    Order** src = orders;
+    Order** dst = ordersTmp;
+    for (int shift = 0; shift < 64; shift += 16)
+    {
+        for (int d = 0; d < (1 << 16); d++)
+            bucket[d] = 0;
+        for (int i = 0; i < n; i++)
+            bucket[(keys[i] >> shift) & 0xFFFF]++;
+        if (bucket[(keys[0] >> shift) & 0xFFFF] == n)
+            continue;
+
+        int start = 0;
+        for (int d = 0; d < (1 << 16); d++)
+        {
+            int count = bucket[d];
+            bucket[d] = start;
+            start += count;
+        }
+        for (int i = 0; i < n; i++)
+        {
+            int pos = bucket[(keys[i] >> shift) & 0xFFFF]++;
+            keysTmp[pos] = keys[i];
+            dst[pos] = src[i];
+        }
+
+        unsigned long long* k = keys; keys = keysTmp; keysTmp = k;
+        Order** o = src; src = dst; dst = o;
+    }
+
+    if (src != orders)
+        for (int i = 0; i < n; i++)
+            orders[i] = src[i];
+
+    delete[] keys;
+    delete[] keysTmp;
+    delete[] (src != orders ? src : dst);
+    delete[] bucket;
+}
+
 // Write output file with all simulation results and statistics
 // Must be called at end of simulation
-// Complexity: O(N log N) where N = finished orders (for sorting)
-void Restaurant::WriteOutputFile(const std::string& filename)
+// The whole report is built in memory and written with one call
+// Complexity: O(N) where N = finished orders
+bool Restaurant::WriteOutputFile(const std::string& filename)
 {
     ofstream outFile(filename);
     if (!outFile.is_open())
     {
-        if (pGUI) pGUI->PrintMessage("ERROR: Cannot write to output file");
-        return;
+        ReportError("Cannot write to output file: " + filename);
+        return false;
+    }
+
+    for (int i = 0; i < TYPE_CNT; i++)
+        outputCount[i] = 0;
+
+    // About 30 characters per order line, plus the cook lines
+    int totalCooks = normalCooks.getSize() + veganCooks.getSize() + vipCooks.getSize();
+    OutputBuffer buffer((size_t)finished.getSize() * 32 + (size_t)totalCooks * 128 + 4096);
+
+    buffer.append("FT\tID\tAT\tWT\tST\n");
+    WriteFinishedOrders(buffer);
+    WriteStatistics(buffer);
+
+    if (!buffer.writeTo(outFile))
+    {
+        ReportError("Cannot write to output file: " + filename);
+        return false;
     }
+    outFile.close();
+    
+    if (pObserver)
+        pObserver->PrintMessage("Output file written successfully: " + filename);
+    return true;
+}
 
+// Appends the orders in `finished` sorted by FT, then by ST, and adds them to
+// the per-type output counts
+void Restaurant::WriteFinishedOrders(OutputBuffer& out)
+{
     // Convert finished linked list to array for sorting
     int numOrders = finished.getSize();
     Order** orderArray = new Order*[numOrders];
@@ -1017,65 +1304,58 @@ void Restaurant::WriteOutputFile(const std::string& filename)
         curr = curr->getNext();
     }
 
-    // Sort orders by FT, then by ST (bubble sort for simplicity)
-    for (int i = 0; i < numOrders - 1; i++)
-    {
-        for (int j = 0; j < numOrders - i - 1; j++)
-        {
-            Order* o1 = orderArray[j];
-            Order* o2 = orderArray[j + 1];
-            
-            int ft1 = o1->GetFinishTime();
-            int ft2 = o2->GetFinishTime();
-            int st1 = o1->GetServTime();
-            int st2 = o2->GetServTime();
-            
-            // Sort by FT first, then by ST
-            bool shouldSwap = false;
-            if (ft1 > ft2)
-                shouldSwap = true;
-            else if (ft1 == ft2 && st1 > st2)
-                shouldSwap = true;
-                
-            if (shouldSwap)
-            {
-                Order* temp = orderArray[j];
-                orderArray[j] = orderArray[j + 1];
-                orderArray[j + 1] = temp;
-            }
-        }
-    }
-
-    // Write header
-    outFile << "FT\tID\tAT\tWT\tST\n";
+    SortByFinishThenService(orderArray, numOrders);
 
     // Write sorted orders
+    out.reserve((size_t)numOrders * 5 * 12);
     for (int i = 0; i < numOrders; i++)
     {
         Order* ord = orderArray[i];
         int ft = ord->GetFinishTime();
-        int id = ord->GetID();
-        int at = ord->GetArrTime();
         int wt = ord->GetServTime() - ord->GetArrTime();  // WT = ServTime - ArrTime
         int st = ft - ord->GetServTime();                  // ST = FinishTime - ServTime
 
-        outFile << ft << "\t" << id << "\t" << at << "\t" 
-                << wt << "\t" << st << "\n";
+        out.appendInt(ft);                out.append('\t');
+        out.appendInt(ord->GetID());      out.append('\t');
+        out.appendInt(ord->GetArrTime()); out.append('\t');
+        out.appendInt(wt);                out.append('\t');
+        out.appendInt(st);                out.append('\n');
+
+        outputCount[ord->GetType()]++;
     }
 
     delete[] orderArray;
+}
 
-    // Count orders by type
-    int normalCount = 0, veganCount = 0, vipCount = 0;
-    curr = finished.getHead();
-    while (curr)
-    {
-        ORD_TYPE type = curr->getItem()->GetType();
-        if (type == TYPE_NRM) normalCount++;
-        else if (type == TYPE_VGAN) veganCount++;
-        else if (type == TYPE_VIP) vipCount++;
-        curr = curr->getNext();
-    }
+// One "Cook X<id>: ..." line of the report
+static void AppendCookLine(OutputBuffer& out, char typeLetter, Cook* cook)
+{
+    out.append("Cook ");
+    out.append(typeLetter);
+    out.appendInt(cook->GetID());
+    out.append(": Orders [Norm:");
+    out.appendInt(cook->getNormalOrdersServed());
+    out.append(", Veg:");
+    out.appendInt(cook->getVeganOrdersServed());
+    out.append(", VIP:");
+    out.appendInt(cook->getVIPOrdersServed());
+    out.append("], Busy: ");
+    out.appendInt(cook->getTotalBusyTime());
+    out.append(", Idle: ");
+    out.appendInt(cook->getTotalIdleTime());
+    out.append(", Break/Injury: ");
+    out.appendInt(cook->getTotalBreakTime());
+    out.append(", Utilization: ");
+    out.appendFixed(cook->getUtilization(), 1);
+    out.append("%\n");
+}
+
+void Restaurant::WriteStatistics(OutputBuffer& out)
+{
+    int normalCount = outputCount[TYPE_NRM];
+    int veganCount = outputCount[TYPE_VGAN];
+    int vipCount = outputCount[TYPE_VIP];
+    int numOrders = normalCount + veganCount + vipCount;
 
     // Calculate averages
     double avgWait = (CountFinished > 0) ? (double)TotalWaitTime / CountFinished : 0.0;
@@ -1085,75 +1365,111 @@ void Restaurant::WriteOutputFile(const std::string& filename)
     int totalCooks = normalCooks.getSize() + veganCooks.getSize() + vipCooks.getSize();
 
     // Write statistics
-    outFile << "\nOrders: " << numOrders 
-            << " [Norm:" << normalCount 
-            << ", Veg:" << veganCount 
-            << ", VIP:" << vipCount << "]\n";
-    
-    outFile << "Cooks: " << totalCooks
-            << " [Norm:" << normalCooks.getSize()
-            << ", Veg:" << veganCooks.getSize()
-            << ", VIP:" << vipCooks.getSize() << "]\n";
-    
-    outFile << "Avg Wait = " << fixed << setprecision(2) << avgWait
-            << ", Avg Serv = " << avgServ << "\n";
-    
-    outFile << "Auto-promoted: " << autoPromotedCount << "\n";
-    outFile << "Late Orders: " << lateOrderCount << "\n";
+    out.append("\nOrders: ");
+    out.appendInt(numOrders);
+    out.append(" [Norm:");
+    out.appendInt(normalCount);
+    out.append(", Veg:");
+    out.appendInt(veganCount);
+    out.append(", VIP:");
+    out.appendInt(vipCount);
+    out.append("]\n");
+
+    out.append("Cooks: ");
+    out.appendInt(totalCooks);
+    out.append(" [Norm:");
+    out.appendInt(normalCooks.getSize());
+    out.append(", Veg:");
+    out.appendInt(veganCooks.getSize());
+    out.append(", VIP:");
+    out.appendInt(vipCooks.getSize());
+    out.append("]\n");
+
+    out.append("Avg Wait = ");
+    out.appendFixed(avgWait, 2);
+    out.append(", Avg Serv = ");
+    out.appendFixed(avgServ, 2);
+    out.append("\n");
+
+    out.append("Auto-promoted: ");
+    out.appendInt(autoPromotedCount);
+    out.append("\nLate Orders: ");
+    out.appendInt(lateOrderCount);
+    out.append("\n");
 
     // Per-cook statistics
-    // Normal cooks
-    Node<Cook*>* cookNode = normalCooks.getHead();
-    while (cookNode)
+    LinkedList<Cook*>* allLists[] = { &normalCooks, &veganCooks, &vipCooks };
+    const char typeLetters[] = { 'N', 'G', 'V' };
+    for (int i = 0; i < 3; i++)
     {
-        Cook* cook = cookNode->getItem();
-        outFile << "Cook N" << cook->GetID() << ": Orders [Norm:"
-                << cook->getNormalOrdersServed() << ", Veg:"
-                << cook->getVeganOrdersServed() << ", VIP:"
-                << cook->getVIPOrdersServed() << "], Busy: "
-                << cook->getTotalBusyTime() << ", Idle: "
-                << cook->getTotalIdleTime() << ", Break/Injury: "
-                << cook->getTotalBreakTime() << ", Utilization: "
-                << fixed << setprecision(1) << cook->getUtilization() << "%\n";
-        cookNode = cookNode->getNext();
+        Node<Cook*>* cookNode = allLists[i]->getHead();
+        while (cookNode)
+        {
+            AppendCookLine(out, typeLetters[i], cookNode->getItem());
+            cookNode = cookNode->getNext();
+        }
     }
 
-    // Vegan cooks
-    cookNode = veganCooks.getHead();
-    while (cookNode)
+    if (memoryReport)
+        WriteMemoryReport(out);
+}
+
+// Counters of this thread at the time of the report: orders still listed
+// in the report are live, and the cooks are freed with the restaurant
+void Restaurant::WriteMemoryReport(OutputBuffer& out)
+{
+    int steps = (lastTimeStep > 0) ? lastTimeStep : 1;
+
+    out.append("Memory [live bytes / peak bytes, allocations]\n");
+    for (int t = 0; t < ALLOC_TAG_CNT; t++)
     {
-        Cook* cook = cookNode->getItem();
-        outFile << "Cook G" << cook->GetID() << ": Orders [Norm:"
-                << cook->getNormalOrdersServed() << ", Veg:"
-                << cook->getVeganOrdersServed() << ", VIP:"
-                << cook->getVIPOrdersServed() << "], Busy: "
-                << cook->getTotalBusyTime() << ", Idle: "
-                << cook->getTotalIdleTime() << ", Break/Injury: "
-                << cook->getTotalBreakTime() << ", Utilization: "
-                << fixed << setprecision(1) << cook->getUtilization() << "%\n";
-        cookNode = cookNode->getNext();
+        const AllocCounters& c = AllocTracker::get((ALLOC_TAG)t);
+        out.append(AllocTracker::TagName((ALLOC_TAG)t));
+        out.append(": ");
+        out.appendLong(c.liveBytes);
+        out.append(" / ");
+        out.appendLong(c.peakBytes);
+        out.append(", ");
+        out.appendLong(c.allocations);
+        out.append(" allocs, ");
+        out.appendLong(c.frees);
+        out.append(" frees (");
+        out.appendFixed((double)c.allocations / steps, 2);
+        out.append(" allocs per timestep)\n");
     }
+}
 
-    // VIP cooks
-    cookNode = vipCooks.getHead();
-    while (cookNode)
+void Restaurant::WriteMemorySample(int currentTime)
+{
+    OutputBuffer row(256);
+    row.appendInt(currentTime);
+    for (int t = 0; t < ALLOC_TAG_CNT; t++)
     {
-        Cook* cook = cookNode->getItem();
-        outFile << "Cook V" << cook->GetID() << ": Orders [Norm:"
-                << cook->getNormalOrdersServed() << ", Veg:"
-                << cook->getVeganOrdersServed() << ", VIP:"
-                << cook->getVIPOrdersServed() << "], Busy: "
-                << cook->getTotalBusyTime() << ", Idle: "
-                << cook->getTotalIdleTime() << ", Break/Injury: "
-                << cook->getTotalBreakTime() << ", Utilization: "
-                << fixed << setprecision(1) << cook->getUtilization() << "%\n";
-        cookNode = cookNode->getNext();
+        const AllocCounters& c = AllocTracker::get((ALLOC_TAG)t);
+        long long values[] = { c.liveBytes, c.peakBytes, c.allocations, c.frees };
+        for (long long value : values)
+        {
+            row.append(',');
+            row.appendLong(value);
+        }
     }
+    row.append('\n');
+    row.writeTo(*memorySamples);
 
-    outFile.close();
-    
-    if (pGUI)
-        pGUI->PrintMessage("Output file written successfully: " + filename);
+    nextMemorySample = (currentTime / memorySampleInterval + 1) * memorySampleInterval;
+}
+
+// Streaming mode: orders finishing at this step all have the same FT and all
+// later ones a larger FT, so each step's batch goes out in its final order and
+// the orders are freed instead of piling up until the end of the run
+void Restaurant::FlushFinishedOrders(OutputBuffer& out)
+{
+    WriteFinishedOrders(out);
+    while (!finished.isEmpty())
+    {
+        orderPool.release(finished.getHead()->getItem());
+        finished.DeleteFirst();
+    }
 }
 
 // ========================================
@@ -1181,9 +1497,9 @@ void Restaurant::TriggerCookBreaks(int currentTime)
                 // Penalty: Apply extra fatigue (reduce speed more)
                 cook->applyFatigue();  // Double fatigue penalty
                 
-                if (pGUI)
+                if (pObserver)
                 {
-                    pGUI->PrintMessage("Cook N" + to_string(cook->GetID()) + 
+                    pObserver->PrintMessage("Cook N" + to_string(cook->GetID()) + 
                                       " skipped break (overtime) - extra fatigue applied");
                 }
             }
@@ -1192,9 +1508,9 @@ void Restaurant::TriggerCookBreaks(int currentTime)
                 // Normal break
                 cook->startBreak(currentTime);
                 
-                if (pGUI)
+                if (pObserver)
                 {
-                    pGUI->PrintMessage("Cook N" + to_string(cook->GetID()) + 
+                    pObserver->PrintMessage("Cook N" + to_string(cook->GetID()) + 
                                       " started break");
                 }
             }
@@ -1215,9 +1531,9 @@ void Restaurant::TriggerCookBreaks(int currentTime)
             {
                 cook->applyFatigue();  // Overtime penalty
                 
-                if (pGUI)
+                if (pObserver)
                 {
-                    pGUI->PrintMessage("Cook G" + to_string(cook->GetID()) + 
+                    pObserver->PrintMessage("Cook G" + to_string(cook->GetID()) + 
                                       " skipped break (overtime) - extra fatigue applied");
                 }
             }
@@ -1225,9 +1541,9 @@ void Restaurant::TriggerCookBreaks(int currentTime)
             {
                 cook->startBreak(currentTime);
                 
-                if (pGUI)
+                if (pObserver)
                 {
-                    pGUI->PrintMessage("Cook G" + to_string(cook->GetID()) + 
+                    pObserver->PrintMessage("Cook G" + to_string(cook->GetID()) + 
                                       " started break");
                 }
             }
@@ -1248,9 +1564,9 @@ void Restaurant::TriggerCookBreaks(int currentTime)
             {
                 cook->applyFatigue();  // Overtime penalty
                 
-                if (pGUI)
+                if (pObserver)
                 {
-                    pGUI->PrintMessage("Cook V" + to_string(cook->GetID()) + 
+                    pObserver->PrintMessage("Cook V" + to_string(cook->GetID()) + 
                                       " skipped break (overtime) - extra fatigue applied");
                 }
             }
@@ -1258,9 +1574,9 @@ void Restaurant::TriggerCookBreaks(int currentTime)
             {
                 cook->startBreak(currentTime);
                 
-                if (pGUI)
+                if (pObserver)
                 {
-                    pGUI->PrintMessage("Cook V" + to_string(cook->GetID()) + 
+                    pObserver->PrintMessage("Cook V" + to_string(cook->GetID()) + 
                                       " started break");
                 }
             }
@@ -1281,98 +1597,66 @@ bool Restaurant::isSystemOverloaded() const
 }
 
 // Trigger random health emergencies (injuries) for cooks
-// Probability: 0.1% per cook per timestep (about 1 injury per 1000 timesteps per cook)
-// Recovery duration: 10 timesteps
+// Probability: InjuryProbability per available or busy cook per timestep
+// (0.1%, about 1 injury per 1000 timesteps per cook), recovery InjuryRecovery
+// The draw for (timestep, cook) comes from this run's Philox stream, so runs
+// with the same seed and stream repeat exactly and other streams differ
 // Complexity: O(C) where C = total number of cooks
 void Restaurant::TriggerRandomInjuries(int currentTime)
 {
-    // Random injury probability: 0.1% = 0.001
-    // Using simple pseudo-random based on current time and cook ID
-    
-    // Check all cooks for potential injury
-    Node<Cook*>* cookNode = normalCooks.getHead();
-    while (cookNode)
-    {
-        Cook* cook = cookNode->getItem();
-        
-        // Only available or busy cooks can get injured (not already injured/on break)
-        if (cook->isAvailable() || cook->isBusy())
-        {
-            // Pseudo-random: if (time * 7 + id * 13) % 1000 == 0, trigger injury
-            // This gives approximately 0.1% chance
-            int randomValue = (currentTime * 7 + cook->GetID() * 13) % 1000;
-            
-            if (randomValue == 0)  // 0.1% chance
-            {
-                // Injury triggered!
-                int recoveryDuration = 10;  // 10 timesteps to recover
-                cook->setInjured(currentTime, recoveryDuration);
-                
-                if (pGUI)
-                {
-                    pGUI->PrintMessage("Cook N" + to_string(cook->GetID()) + 
-                                      " injured! Recovery: " + to_string(recoveryDuration) + " timesteps");
-                }
-            }
-        }
-        
-        cookNode = cookNode->getNext();
-    }
-    
-    // Check Vegan cooks
-    cookNode = veganCooks.getHead();
-    while (cookNode)
+    PHASE_TIMER(phaseProfile, PHASE_INJURIES);
+    LinkedList<Cook*>* allLists[] = { &normalCooks, &veganCooks, &vipCooks };
+    const char typeLetters[] = { 'N', 'G', 'V' };
+
+    for (int i = 0; i < 3; i++)
     {
-        Cook* cook = cookNode->getItem();
-        
-        if (cook->isAvailable() || cook->isBusy())
+        Node<Cook*>* cookNode = allLists[i]->getHead();
+        while (cookNode)
         {
-            int randomValue = (currentTime * 7 + cook->GetID() * 13) % 1000;
-            
-            if (randomValue == 0)
+            Cook* cook = cookNode->getItem();
+
+            // Only available or busy cooks can get injured (not already injured/on break)
+            if ((cook->isAvailable() || cook->isBusy()) &&
+                injuryRng.uniform((uint32_t)currentTime, (uint32_t)cook->GetType(), (uint32_t)cook->GetID()) < InjuryProbability)
             {
-                int recoveryDuration = 10;
-                cook->setInjured(currentTime, recoveryDuration);
-                
-                if (pGUI)
+                InjureCook(cook, currentTime, InjuryRecovery);
+
+                if (pObserver)
                 {
-                    pGUI->PrintMessage("Cook G" + to_string(cook->GetID()) + 
-                                      " injured! Recovery: " + to_string(recoveryDuration) + " timesteps");
+                    pObserver->PrintMessage(string("Cook ") + typeLetters[i] + to_string(cook->GetID()) +
+                                      " injured! Recovery: " + to_string(InjuryRecovery) + " timesteps");
                 }
             }
+
+            cookNode = cookNode->getNext();
         }
-        
-        cookNode = cookNode->getNext();
     }
-    
-    // Check VIP cooks
-    cookNode = vipCooks.getHead();
-    while (cookNode)
+}
+
+// An injured cook stops cooking: its order (if any) finishes recoveryDuration
+// timesteps later and can no longer be preempted
+// Complexity: O(log B)
+void Restaurant::InjureCook(Cook* cook, int currentTime, int recoveryDuration)
+{
+    Order* ord = cook->getCurrentOrder();
+    if (ord)
     {
-        Cook* cook = cookNode->getItem();
-        
-        if (cook->isAvailable() || cook->isBusy())
+        int finishTime;
+        if (inService.getKey(ord->getServiceHandle(), finishTime))
         {
-            int randomValue = (currentTime * 7 + cook->GetID() * 13) % 1000;
-            
-            if (randomValue == 0)
-            {
-                int recoveryDuration = 10;
-                cook->setInjured(currentTime, recoveryDuration);
-                
-                if (pGUI)
-                {
-                    pGUI->PrintMessage("Cook V" + to_string(cook->GetID()) + 
-                                      " injured! Recovery: " + to_string(recoveryDuration) + " timesteps");
-                }
-            }
+            inService.erase(ord->getServiceHandle());
+            ord->setServiceHandle(inService.push(ord, finishTime + recoveryDuration));
         }
-        
-        cookNode = cookNode->getNext();
+        preemptible.erase(ord->getPreemptHandle());
+        ord->setPreemptHandle(-1);
     }
+
+    cook->setInjured(currentTime, recoveryDuration);
 }
 
-void Restaurant::AddVIPOrder(Order* order, int priority)
+// priority: before aging (VIPQueue adds what the order gains while waiting)
+void Restaurant::AddVIPOrder(Order* order, double priority)
 {
     waitVIP.enqueue(order, priority);
+    orderIndex.insert(order, LOC_WAIT_VIP);
 }
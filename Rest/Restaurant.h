@@ -1,68 +1,203 @@
 #ifndef __RESTAURANT_H_
 #define __RESTAURANT_H_
 
-#include "..\Defs.h"
-#include "..\GUI\GUI.h"
-#include "..\LinkedList.h"
-#include "..\Events\Event.h"
+#include "../Defs.h"
+#include "SimObserver.h"
+#include "../LinkedList.h"
+#include "../Events/Event.h"
+#include "../Events/EventCalendar.h"
 #include "Order.h"
 #include "Cook.h"
+#include "OrderIndex.h"
+#include "OrderPool.h"
+#include "CookPool.h"
+#include "CookTable.h"
+#include "VIPQueue.h"
+#include "PhaseProfile.h"
 #include <string>
+#include <iosfwd>
 #include "../priQueue.h"
 #include "../LinkedQueue.h"
+#include "../Generic_DS/HandleHeap.h"
+#include "../Generic_DS/TimingWheel.h"
+#include "../Generic_DS/AllocTracker.h"
+#include "../Sim/Philox.h"
+#include "../IO/EventTrace.h"
 #include "../Rest/Cook.h"
 
+class GUI;
+class TraceParser;
+class RTraceFile;
+class OutputBuffer;
+class RunMonitor;
+
+// Headline numbers of a finished run (as in the statistics of the report)
+struct SimSummary
+{
+    int finishedOrders;
+    double avgWait;
+    double avgServ;
+    int lateOrders;
+    int pendingOrders;          // arrived but neither finished nor cancelled
+                                // (at the end of a run: never served)
+    int autoPromoted;
+    long long totalWait;        // sum of the waiting times (avgWait numerator)
+    long long events;           // events executed
+    int simulatedSteps;         // timesteps simulated (not the idle ones jumped over)
+    int lastTimeStep;
+};
+
+// Current load of a restaurant, as seen by a multi-branch dispatcher
+struct BranchLoad
+{
+    int waitingOrders;
+    int servingOrders;
+    int freeCooks;
+    int cooks;
+    double avgServ;             // average service time so far (0 before the first)
+};
+
 class Restaurant
 {
 private:
-    GUI* pGUI;
+    // Preemption order: latest service start first (least work wasted),
+    // then the cook's position in normalCooks
+    struct PreemptKey {
+        int negStartTime;
+        int cookSlot;
+        bool operator<(const PreemptKey& other) const {
+            if (negStartTime != other.negStartTime) return negStartTime < other.negStartTime;
+            return cookSlot < other.cookSlot;
+        }
+    };
+
+    GUI* pGUI;                  // window, GUI build only (see RestaurantGUI.cpp)
+    SimObserver* pObserver;     // receives simulation messages (nullptr = none)
+    PhaseProfile* phaseProfile; // times the phases of each timestep (nullptr = none)
+    std::string lastError;
 
     int AutoP;
     int autoPromotedCount;
 
-    // Events must be in a traversable list (not Queue)
-    LinkedList<Event*> Events;
+    // Pending events ordered by timestep (stable for equal times)
+    EventCalendar Events;
+
+    // Streaming mode: the input stays open and Events only holds a read-ahead
+    // window of it (see StreamEvents)
+    static const int StreamWindow = 4096;
+    static const int StreamFlushSize = 1 << 20;   // output bytes per write
+    bool streamEvents;
+    TraceParser* eventStream;   // nullptr once the input is exhausted
+    int streamedUpTo;           // timestep of the last event read
+    bool streamFailed;
+
+    // .rtrace input: events run straight from the mapped records, in order
+    // (Events stays empty)
+    RTraceFile* binaryTrace;
+    const RTraceRecord* nextRecord;
+
+    // Replay of a trace shared with other runs (Events stays empty)
+    const EventTrace* sharedTrace;
+    EventTrace::Cursor traceCursor;
+
+    // Random injuries (off unless enabled with setRandomInjuries)
+    static const int InjuryRecovery = 10;          // timesteps
+    static constexpr double InjuryProbability = 0.001;  // per cook per timestep
+    bool injuriesEnabled;
+    Philox4x32 injuryRng;
+
+    // Storage of every order of this run (freed in bulk with the restaurant)
+    OrderPool orderPool;
 
     // Waiting lists per order type
-    LinkedList<Order*> waitNormal;
-    LinkedQueue<Order*> waitVegan;  // FIFO for vegan
-    priQueue<Order*> waitVIP;        // Priority Queue for VIP
+    // Order lists recycle their nodes (NodePool): orders move through them
+    // all the time, and a pool stops allocating once the list is warm
+    LinkedList<Order*, NodePool<Order*>> waitNormal;
+    LinkedQueue<Order*, NodePool<Order*>> waitVegan;  // FIFO for vegan
+    VIPQueue waitVIP;                // VIP orders by their aged priority
+
+    // Auto-promotion timer of every waiting Normal order
+    TimingWheel<Order*> promotionWheel;
+
+    // Order ID -> current queue / list node of every live order
+    OrderIndex orderIndex;
+
+    // In-Service orders keyed on their finish time (computed once at assignment)
+    HandleHeap<Order*, int> inService;
 
-    // In-Service and Finished lists (Phase 1 requirement)
-    LinkedList<Order*> inService;
-    LinkedList<Order*> finished;
+    // Busy Normal cooks serving Normal orders (the only preemption victims)
+    HandleHeap<Cook*, PreemptKey> preemptible;
+    LinkedList<Order*, NodePool<Order*>> finished;
 
     // Cook lists (loaded from input)
     LinkedList<Cook*> normalCooks;
     LinkedList<Cook*> veganCooks;
     LinkedList<Cook*> vipCooks;
 
+    // Per-field state of every cook (the Cook objects are rows of it)
+    CookTable cookTable;
+
+    // Available cooks per COOK_TYPE, in list order (updated by Cook itself)
+    CookPool freeCooks[COOK_CNT];
+
 
 
 
     void UpdateServiceList(int CurrentTimeStep);
 
-    int TotalWaitTime;
-    int TotalServTime;
-    int TotalTurnaround;
+    // 64-bit: an understaffed configuration overflows an int wait total
+    long long TotalWaitTime;
+    long long TotalServTime;
+    long long TotalTurnaround;
     int CountFinished;
     int lateOrderCount;  // Track number of late orders
-
-
-    void LoadInputFile(const std::string& filename);
+    int arrivedCount;
+    int cancelledCount;
+    int outputCount[TYPE_CNT];  // Orders written to the output file per type
+    long long executedEvents;
+    int simulatedSteps;
+    int lastTimeStep;
+
+    // Memory accounting (AllocTracker): trailer of the report, CSV samples
+    bool memoryReport;
+    std::ostream* memorySamples;
+    int memorySampleInterval;
+    int nextMemorySample;       // timestep of the next sample
+
+
+    void CreateCooks(const TraceHeader& header);
+    void RegisterCookPools();
+    void StreamEvents(int currentTime);
+    bool LoadBinaryTrace(const std::string& filename);
+    int NextEventTime();
     void ExecuteEvents(int currentTime);
-    void MoveOneFromEachWaitToInService();
-    void MoveOneFromInServiceToFinished();
+    void UpdateCookStatuses(int currentTime);
+    int AdvanceTime(int currentTime, bool jumpMode);
+    void ReportError(const std::string& msg);
+    void WriteFinishedOrders(OutputBuffer& out);
+    void WriteStatistics(OutputBuffer& out);
+    void WriteMemoryReport(OutputBuffer& out);
+    void WriteMemorySample(int currentTime);
+    void FlushFinishedOrders(OutputBuffer& out);
+    void StartService(Cook* cook, Order* order, int currentTime);
 
     void AssignNormalOrders(int CurrentTimeStep);
     void AssignVeganOrders(int CurrentTimeStep);
 
     void CheckAutoPromotionOptimized(int currentTime);
+    void AutoPromote(Order* order);
+    void SchedulePromotion(Order* order, int currentTime);
+    void RemoveFromNormalList(Order* order);
+    void CancelPromotion(Order* order);
+
+    // Next-event time advance (silent mode)
+    int NextStateChangeTime(int currentTime);
     
     // Dynamic behavior methods
     void TriggerCookBreaks(int currentTime);
     bool isSystemOverloaded() const;
     void TriggerRandomInjuries(int currentTime);
+    void InjureCook(Cook* cook, int currentTime, int recoveryDuration);
 
     //for bonus 1:
     void sortCooksBySpeed(LinkedList<Cook*>& cookList);
@@ -71,9 +206,6 @@ private:
 
     void mergeCooks(Cook** arr, int left, int mid, int right);
     
-    // Output file generation
-    void WriteOutputFile(const std::string& filename);
-    void AddVIPOrder(Order* order, int priority);
 
 
 
@@ -82,10 +214,71 @@ public:
     Restaurant();
     ~Restaurant();
 
-    void RunSimulation();
+    void RunSimulation();    // GUI front-end (asks for mode and input file)
+    bool RunBatch(const std::string& inputFile, const std::string& outputFile, PROG_MODE mode);
+
+    // Loads and simulates silently without writing a report; the results
+    // are read with getSummary (replications, parameter sweeps)
+    bool RunWithoutReport(const std::string& inputFile);
+    SimSummary getSummary() const;
+
+    // Replays an already loaded trace with the cooks and AutoP of header
+    // (not necessarily the trace's own); trace must outlive the run
+    bool LoadTrace(const EventTrace& trace, const TraceHeader& header);
+
+    // Silent run of whatever was loaded; the monitor (if any) is asked every
+    // few timesteps whether to go on. False if the input failed or the
+    // monitor stopped the run
+    bool SimulateWithoutReport(RunMonitor* monitor = nullptr);
+
+    bool LoadInputFile(const std::string& filename);
+    bool WriteOutputFile(const std::string& filename);
+
+    // Read events lazily while the simulation runs (call before loading)
+    // Memory then stays flat however long the input is; the events in the
+    // file must be sorted by timestep
+    void setStreaming(bool streaming);
+
+    // Cooks get injured at random, drawn from the (seed, stream) Philox
+    // stream; every timestep is then simulated (no next-event jumps)
+    void setRandomInjuries(bool enabled, uint32_t seed = 0, uint32_t stream = 0);
+
+    // How waiting VIP orders gain priority over time (call before loading;
+    // default: no aging)
+    void setVIPAging(const VIPAging& aging);
+
+    // Multi-branch mode: a BranchDispatcher owns the clock and hands each
+    // arrival to one branch (through the event callbacks below), then runs
+    // SimulateTimeStep and CloseTimeStep on every branch
+    void Configure(const TraceHeader& header);     // cooks and AutoP
+    void SimulateTimeStep(int currentTime);
+    bool HasPendingWork();
+    // Cook status update of currentTime; returns the next timestep where the
+    // state can change by itself (-1 if none)
+    int CloseTimeStep(int currentTime);
+    void BillSkippedTimeSteps(int skipped);
+    BranchLoad getLoad() const;
+
+    void setObserver(SimObserver* pObs);
+
+    // Phase timings go to profile (builds with RESTAURANT_PHASE_TIMERS only)
+    // One profile per restaurant: it is not synchronized and counts the
+    // timesteps of its restaurant.
+    void setPhaseProfile(PhaseProfile* profile);
+
+    // Live / peak bytes and allocations per subsystem (see AllocTracker)
+    // after the statistics of the report
+    void setMemoryReport(bool enabled);
+
+    // One CSV row of the same counters every `interval` timesteps to out
+    // (nullptr: none); out must outlive the run
+    void setMemorySamples(std::ostream* out, int interval);
+    const std::string& getLastError() const;
 
     // Callbacks from Events
+    Order* CreateOrder(int id, ORD_TYPE type);
     void AddToWaitingList(Order* pOrd);
+    void AddVIPOrder(Order* order, double priority);
     void CancelOrder(int orderID);
     void PromoteOrder(int orderID, int extraMoney);
 
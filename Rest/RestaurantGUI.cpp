@@ -0,0 +1,146 @@
+#include "Restaurant.h"
+#include "../GUI/GUI.h"
+#include <fstream>
+#include <string>
+#include <ctime>
+
+// GUI front-end of the simulation (Windows build only)
+// The headless build runs the same timestep phases through RunBatch
+
+// The main simulation loop 
+void Restaurant::RunSimulation()
+{
+    pGUI = new GUI();
+    if (!pGUI) return;
+    pObserver = pGUI;   // simulation messages go to the status bar
+
+    PROG_MODE mode = pGUI->getGUIMode();
+
+    if (mode == MODE_INTR || mode == MODE_STEP || mode == MODE_SLNT || mode == MODE_DEMO)
+    {
+        string filename = "test.txt";
+
+		// Interactive & Step-by-step and checking file existence and asking user for it
+        if (mode == MODE_INTR || mode == MODE_STEP)
+        {
+            bool opened = false;
+            while (!opened)
+            {
+                pGUI->PrintMessage("Enter input file name (e.g. test.txt): ");
+                filename = pGUI->GetString();
+                if (filename.empty()) filename = "test.txt";
+
+                ifstream test(filename);
+                if (test.is_open())
+                {
+                    test.close();
+                    opened = true;
+                    pGUI->PrintMessage("Loading: " + filename);
+                }
+                else
+                {
+                    pGUI->PrintMessage("File not found! Try again...");
+                }
+            }
+        }
+
+		// Demo mode and checking file existence and asking user for it
+        if (mode == MODE_DEMO || mode == MODE_SLNT)
+        {
+            bool opened = false;
+            while (!opened)
+            {
+                pGUI->PrintMessage("Enter input file name for DEMO (e.g. test.txt): ");
+                filename = pGUI->GetString();
+                if (filename.empty()) filename = "test.txt";
+
+                ifstream test(filename);
+                if (test.is_open())
+                {
+                    test.close();
+                    opened = true;
+                    pGUI->PrintMessage("Loading: " + filename);
+                }
+                else
+                {
+                    pGUI->PrintMessage("File not found! Try again...");
+                }
+            }
+        }
+
+        LoadInputFile(filename);
+
+        int CurrentTimeStep = 1;
+
+        // Silent mode draws nothing between steps, so it jumps straight to
+        // the next timestep where the state can change (next-event mode)
+        bool jumpMode = (mode == MODE_SLNT);
+
+        while (true)
+        {
+            SimulateTimeStep(CurrentTimeStep);
+
+            {
+                PHASE_TIMER(phaseProfile, PHASE_DRAWING);
+                FillDrawingList();
+                pGUI->UpdateInterface();
+            }
+            pGUI->PrintMessage("Time Step: " + to_string(CurrentTimeStep));
+
+            if (mode == MODE_INTR || mode == MODE_STEP)
+                pGUI->waitForClick();
+            else if (mode == MODE_DEMO)
+            {
+                clock_t delay = clock();
+				while (clock() - delay < 400) {}  // for delay to visualize
+            }
+
+			// to finish simulation
+            if (!HasPendingWork())
+                break;
+
+            CurrentTimeStep = AdvanceTime(CurrentTimeStep, jumpMode);
+            if (CurrentTimeStep < 0)
+                break;
+        }
+
+        // Write output file
+        WriteOutputFile("output.txt");
+        
+        pGUI->PrintMessage("Simulation Finished Successfully!");
+        if (mode != MODE_SLNT)
+            pGUI->waitForClick();
+    }
+
+    pObserver = nullptr;
+    delete pGUI;
+    pGUI = nullptr;
+}
+// GUI support 
+void Restaurant::FillDrawingList()
+{
+    pGUI->ResetDrawingList();
+
+    Node<Order*>* p;
+
+    p = waitNormal.getHead(); while (p) { pGUI->AddToDrawingList(p->getItem()); p = p->getNext(); }
+    p = waitVegan.getHead();  while (p) { pGUI->AddToDrawingList(p->getItem()); p = p->getNext(); }
+    // For priQueue, we cannot access nodes directly. Use getItem(i, ref)
+    for (int i = 0; i < waitVIP.getSize(); i++) {
+        Order* ord;
+        if (waitVIP.getItem(i, ord))
+            pGUI->AddToDrawingList(ord);
+    }
+
+    for (int i = 0; i < inService.getSize(); i++) {
+        Order* ord;
+        if (inService.getItem(i, ord))
+            pGUI->AddToDrawingList(ord);
+    }
+    p = finished.getHead();   while (p) { pGUI->AddToDrawingList(p->getItem()); p = p->getNext(); }
+
+    // مفيش Cooks في Phase 1 خالص
+
+
+}
+
@@ -0,0 +1,17 @@
+#ifndef __RUN_MONITOR_H_
+#define __RUN_MONITOR_H_
+
+class Restaurant;
+
+// Watches a silent run (Restaurant::SimulateWithoutReport) and may cut it
+// short, e.g. once a parameter sweep knows the run cannot pay off
+class RunMonitor
+{
+public:
+    virtual ~RunMonitor() {}
+
+    // Called every few timesteps; returning false stops the run
+    virtual bool KeepRunning(const Restaurant& rest, int currentTime) = 0;
+};
+
+#endif
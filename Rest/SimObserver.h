@@ -0,0 +1,20 @@
+#ifndef __SIM_OBSERVER_H_
+#define __SIM_OBSERVER_H_
+
+#include <string>
+
+// Receives what the simulation reports while it runs
+// The GUI window implements it for the Windows build; headless runs use a
+// console observer or none at all (Restaurant skips message building then)
+class SimObserver
+{
+public:
+	virtual ~SimObserver() {}
+
+	virtual void PrintMessage(std::string msg) const = 0;
+
+	// Called once per simulated timestep (step-by-step / interactive modes)
+	virtual void OnTimeStep(int /*currentTime*/) {}
+};
+
+#endif
@@ -0,0 +1,195 @@
+#include "VIPQueue.h"
+#include "Order.h"
+#include <cstdlib>
+#include <cassert>
+
+VIPAging::VIPAging()
+    : segments(1)
+{
+    start[0] = 0;
+    slope[0] = 0.0;
+}
+
+bool VIPAging::Parse(const std::string& spec, VIPAging& aging)
+{
+    VIPAging rule;
+    rule.segments = 0;
+
+    size_t pos = 0;
+    while (pos <= spec.size())
+    {
+        size_t end = spec.find(',', pos);
+        if (end == std::string::npos) end = spec.size();
+        std::string part = spec.substr(pos, end - pos);
+        if (part.empty() || rule.segments == MaxSegments)
+            return false;
+
+        int from = 0;
+        size_t colon = part.find(':');
+        if (colon != std::string::npos)
+        {
+            char* rest;
+            from = (int)strtol(part.c_str(), &rest, 10);
+            if (rest != part.c_str() + colon)
+                return false;
+            part = part.substr(colon + 1);
+        }
+        else if (rule.segments > 0)
+            return false;       // only the first segment may omit its start
+
+        char* rest;
+        double slope = strtod(part.c_str(), &rest);
+        if (part.empty() || *rest != '\0')
+            return false;
+
+        int prev = rule.segments > 0 ? rule.start[rule.segments - 1] : -1;
+        if ((rule.segments == 0 && from != 0) || from <= prev)
+            return false;
+
+        rule.start[rule.segments] = from;
+        rule.slope[rule.segments] = slope;
+        rule.segments++;
+        pos = end + 1;
+    }
+
+    aging = rule;
+    return true;
+}
+
+VIPQueue::VIPQueue()
+    : now(0), count(0)
+{
+    setAging(VIPAging());
+}
+
+void VIPQueue::setAging(const VIPAging& rule)
+{
+    if (count > 0) return;
+
+    aging = rule;
+    gainedAtStart[0] = 0.0;
+    for (int k = 1; k < aging.segments; k++)
+        gainedAtStart[k] = gainedAtStart[k - 1]
+            + aging.slope[k - 1] * (aging.start[k] - aging.start[k - 1]);
+}
+
+// Complexity: O(K)
+int VIPQueue::segmentOf(int waited) const
+{
+    int k = 0;
+    while (k + 1 < aging.segments && waited >= aging.start[k + 1])
+        k++;
+    return k;
+}
+
+void VIPQueue::insert(Order* pOrd, double base, int segment)
+{
+    double key = base + gainedAtStart[segment]
+        - aging.slope[segment] * ((double)aging.start[segment] + pOrd->GetArrTime());
+    pOrd->setQueueHandle(byKey[segment].enqueue(pOrd, key));
+    if (segment + 1 < aging.segments)
+        pOrd->setAgingHandle(byArrival[segment].push(pOrd, pOrd->GetArrTime()));
+}
+
+// Complexity: O(log W) per order that changes segment
+void VIPQueue::advanceTo(int currentTime)
+{
+    if (currentTime <= now) return;
+    now = currentTime;
+
+    // A moved order lands in a later segment with its boundary still ahead,
+    // so one pass in segment order is enough
+    for (int k = 0; k + 1 < aging.segments; k++)
+    {
+        Order* pOrd;
+        int arrTime;
+        while (byArrival[k].peek(pOrd, arrTime) && now - arrTime >= aging.start[k + 1])
+        {
+            byArrival[k].pop(pOrd, arrTime);
+
+            double key = 0;
+            bool live = byKey[k].getPriority(pOrd->getQueueHandle(), key);
+            assert(live);   // byArrival and byKey hold the same orders
+            (void)live;
+            byKey[k].erase(pOrd->getQueueHandle());
+
+            // Back to the base priority, then the key of the new segment
+            double base = key - gainedAtStart[k]
+                + aging.slope[k] * ((double)aging.start[k] + arrTime);
+            insert(pOrd, base, segmentOf(now - arrTime));
+        }
+    }
+}
+
+// Orders are added when they arrive or get promoted, at the current timestep
+// (or just before it, while the clock is still on the last one: they then
+// move when the clock catches up)
+void VIPQueue::enqueue(Order* pOrd, double base)
+{
+    int waited = now - pOrd->GetArrTime();
+    insert(pOrd, base, waited > 0 ? segmentOf(waited) : 0);
+    count++;
+}
+
+// Earlier segments win ties
+int VIPQueue::bestSegment(double& priority) const
+{
+    int best = -1;
+    for (int k = 0; k < aging.segments; k++)
+    {
+        Order* pOrd;
+        double key;
+        if (!byKey[k].peek(pOrd, key)) continue;
+        double current = key + aging.slope[k] * now;
+        if (best < 0 || current > priority)
+        {
+            best = k;
+            priority = current;
+        }
+    }
+    return best;
+}
+
+bool VIPQueue::peek(Order*& pOrd, double& priority) const
+{
+    int k = bestSegment(priority);
+    if (k < 0) return false;
+    double key;
+    return byKey[k].peek(pOrd, key);
+}
+
+bool VIPQueue::dequeue(Order*& pOrd, double& priority)
+{
+    int k = bestSegment(priority);
+    if (k < 0) return false;
+
+    double key;
+    byKey[k].dequeue(pOrd, key);
+    if (k + 1 < aging.segments)
+        byArrival[k].erase(pOrd->getAgingHandle());
+    pOrd->setQueueHandle(-1);
+    pOrd->setAgingHandle(-1);
+    count--;
+    return true;
+}
+
+bool VIPQueue::isEmpty() const
+{
+    return count == 0;
+}
+
+int VIPQueue::getSize() const
+{
+    return count;
+}
+
+bool VIPQueue::getItem(int i, Order*& result) const
+{
+    for (int k = 0; k < aging.segments; k++)
+    {
+        if (i < byKey[k].getSize())
+            return byKey[k].getItem(i, result);
+        i -= byKey[k].getSize();
+    }
+    return false;
+}
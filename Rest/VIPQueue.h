@@ -0,0 +1,88 @@
+#ifndef __VIP_QUEUE_H_
+#define __VIP_QUEUE_H_
+
+#include "../priQueue.h"
+#include "../Generic_DS/HandleHeap.h"
+#include <string>
+
+class Order;
+
+// How the priority of a waiting VIP order grows with its waiting time
+// Piecewise linear: while the order has waited between start[k] and
+// start[k + 1] timesteps it gains slope[k] per timestep, on top of
+// Order::calculateVIPPriority(). The default rule adds nothing.
+struct VIPAging
+{
+    static const int MaxSegments = 8;
+
+    int segments;
+    int start[MaxSegments];     // waiting time where segment k begins (start[0] = 0, increasing)
+    double slope[MaxSegments];  // priority gained per timestep waited in segment k
+
+    VIPAging();
+
+    // "s0[,t1:s1[,t2:s2...]]": slope s0 from the start, s1 once the order
+    // has waited t1 timesteps, ... (e.g. "0.5,10:2,30:5")
+    static bool Parse(const std::string& spec, VIPAging& aging);
+};
+
+// Waiting VIP orders, best current priority first
+// The priority of an order at time now is
+//     base + gained(now - ArrTime)
+// which changes every timestep, but inside one aging segment every order
+// gains the same slope, so
+//     key = base + gained(start[k]) - slope[k] * (start[k] + ArrTime)
+// (priority = key + slope[k] * now) orders the segment the same way at
+// any time. Each segment is one heap on that fixed key; an order only
+// moves (to a later segment) when its waiting time crosses a boundary,
+// found through a second heap on ArrTime per segment. The head is the
+// best of the segment heads.
+//
+// Complexity (K = segments, at most VIPAging::MaxSegments):
+//   enqueue / dequeue      -> O(log W)
+//   peek                   -> O(K)
+//   advanceTo              -> O(log W) per order crossing a boundary
+class VIPQueue
+{
+    VIPAging aging;
+    double gainedAtStart[VIPAging::MaxSegments];    // gained(start[k])
+
+    priQueue<Order*> byKey[VIPAging::MaxSegments];
+    // Orders that still have a boundary ahead (all but the last segment)
+    HandleHeap<Order*, int, 4> byArrival[VIPAging::MaxSegments];
+
+    int now;
+    int count;
+
+    int segmentOf(int waited) const;
+    void insert(Order* pOrd, double base, int segment);
+    int bestSegment(double& priority) const;
+
+public:
+    VIPQueue();
+
+    VIPQueue(const VIPQueue&) = delete;
+    VIPQueue& operator=(const VIPQueue&) = delete;
+
+    // Only while the queue is empty
+    void setAging(const VIPAging& rule);
+
+    // Moves the clock forward; orders whose waiting time crossed a segment
+    // boundary change heaps
+    void advanceTo(int currentTime);
+
+    // base = the order's priority before aging (calculateVIPPriority)
+    void enqueue(Order* pOrd, double base);
+
+    // priority = the current (aged) priority of the head
+    bool peek(Order*& pOrd, double& priority) const;
+    bool dequeue(Order*& pOrd, double& priority);
+
+    bool isEmpty() const;
+    int getSize() const;
+
+    // Traversal for the GUI (segment by segment, in heap order)
+    bool getItem(int i, Order*& result) const;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef __BARRIER_H_
+#define __BARRIER_H_
+
+#include <mutex>
+#include <condition_variable>
+
+// Reusable thread barrier: wait() returns once all `count` threads called it
+// (C++17 has no std::barrier)
+class Barrier
+{
+	std::mutex lock;
+	std::condition_variable released;
+	int count;
+	int waiting;
+	long long generation;	// completed rounds (tells a new round from a spurious wakeup)
+
+public:
+	explicit Barrier(int threadCount)
+		: count(threadCount), waiting(0), generation(0)
+	{
+	}
+
+	Barrier(const Barrier&) = delete;
+	Barrier& operator=(const Barrier&) = delete;
+
+	void wait()
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		long long round = generation;
+		if (++waiting == count)
+		{
+			waiting = 0;
+			generation++;
+			released.notify_all();
+			return;
+		}
+		released.wait(guard, [this, round] { return generation != round; });
+	}
+};
+
+#endif
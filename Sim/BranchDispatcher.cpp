@@ -0,0 +1,285 @@
+#include "BranchDispatcher.h"
+#include <thread>
+#include <cstdio>
+#include <ostream>
+
+BranchDispatcher::BranchDispatcher(const std::string& input, int count, int threadCount, RoutingRule* routing)
+	: inputFile(input), branchCount(count > 0 ? count : 1), threads(threadCount), rule(routing),
+	  cursor(EventTrace::Start()), mapCapacity(1024), mapCount(0),
+	  currentTime(1), closing(false), finished(false)
+{
+	if (threads <= 0)
+		threads = (int)std::thread::hardware_concurrency();
+	if (threads <= 0)
+		threads = 1;
+	if (threads > branchCount)
+		threads = branchCount;
+
+	branches = new Restaurant[branchCount];
+	loads = new BranchLoad[branchCount];
+	active = new bool[branchCount];
+	pending = new bool[branchCount];
+	wakeTime = new int[branchCount];
+	lastStep = new int[branchCount];
+	routedTo = new int[branchCount];
+	for (int b = 0; b < branchCount; b++)
+	{
+		active[b] = false;
+		pending[b] = false;
+		wakeTime[b] = 1;	// every branch runs the first timestep
+		lastStep[b] = 0;
+		routedTo[b] = 0;
+	}
+
+	mapID = new int[mapCapacity];
+	mapBranch = new int[mapCapacity];
+	for (int i = 0; i < mapCapacity; i++)
+		mapBranch[i] = -1;
+}
+
+BranchDispatcher::~BranchDispatcher()
+{
+	delete[] branches;
+	delete[] loads;
+	delete[] active;
+	delete[] pending;
+	delete[] wakeTime;
+	delete[] lastStep;
+	delete[] routedTo;
+	delete[] mapID;
+	delete[] mapBranch;
+}
+
+// Fibonacci hashing, as in OrderIndex
+static int SlotOf(int id, int capacity)
+{
+	unsigned int h = (unsigned int)id * 2654435769u;
+	return (int)(h & (unsigned int)(capacity - 1));
+}
+
+void BranchDispatcher::remember(int orderID, int branch)
+{
+	if (2 * (mapCount + 1) > mapCapacity)
+	{
+		int* oldID = mapID;
+		int* oldBranch = mapBranch;
+		int oldCapacity = mapCapacity;
+		mapCapacity *= 2;
+		mapID = new int[mapCapacity];
+		mapBranch = new int[mapCapacity];
+		for (int i = 0; i < mapCapacity; i++)
+			mapBranch[i] = -1;
+		for (int i = 0; i < oldCapacity; i++)
+		{
+			if (oldBranch[i] < 0) continue;
+			int slot = SlotOf(oldID[i], mapCapacity);
+			while (mapBranch[slot] >= 0)
+				slot = (slot + 1) & (mapCapacity - 1);
+			mapID[slot] = oldID[i];
+			mapBranch[slot] = oldBranch[i];
+		}
+		delete[] oldID;
+		delete[] oldBranch;
+	}
+
+	int slot = SlotOf(orderID, mapCapacity);
+	while (mapBranch[slot] >= 0 && mapID[slot] != orderID)
+		slot = (slot + 1) & (mapCapacity - 1);
+	if (mapBranch[slot] < 0)
+		mapCount++;
+	mapID[slot] = orderID;
+	mapBranch[slot] = branch;
+}
+
+// -1 if the order never arrived
+int BranchDispatcher::branchOf(int orderID) const
+{
+	int slot = SlotOf(orderID, mapCapacity);
+	while (mapBranch[slot] >= 0)
+	{
+		if (mapID[slot] == orderID)
+			return mapBranch[slot];
+		slot = (slot + 1) & (mapCapacity - 1);
+	}
+	return -1;
+}
+
+// Phase 1: every event due now goes to its branch, which then runs this
+// timestep like the branches whose wake time has come
+void BranchDispatcher::routeEvents()
+{
+	for (int b = 0; b < branchCount; b++)
+		active[b] = (wakeTime[b] == currentTime);
+
+	EventRecord rec;
+	bool loadsFresh = false;
+	int t;
+	while ((t = trace.nextTime(cursor)) >= 0 && t <= currentTime)
+	{
+		trace.take(cursor, rec);
+		int b;
+		if (rec.kind == 'R')
+		{
+			if (!loadsFresh)
+			{
+				for (int i = 0; i < branchCount; i++)
+					loads[i] = branches[i].getLoad();
+				loadsFresh = true;
+			}
+			b = rule->Route(rec, loads, branchCount);
+			if (b < 0 || b >= branchCount)
+				b = 0;
+			remember(rec.orderID, b);
+			routedTo[b]++;
+		}
+		else
+		{
+			b = branchOf(rec.orderID);
+			if (b < 0)
+				continue;
+		}
+
+		// Bill the steps the branch slept through before its state changes
+		if (!active[b])
+		{
+			branches[b].BillSkippedTimeSteps(currentTime - lastStep[b] - 1);
+			lastStep[b] = currentTime - 1;
+			active[b] = true;
+		}
+		ExecuteEvent(rec, &branches[b]);
+		if (loadsFresh)
+			loads[b] = branches[b].getLoad();
+	}
+}
+
+// Phase 3: go on while events are left or a branch has work
+bool BranchDispatcher::decideClose()
+{
+	if (trace.nextTime(cursor) >= 0)
+		return true;
+	for (int b = 0; b < branchCount; b++)
+		if (pending[b])
+			return true;
+	return false;
+}
+
+// Phase 5: earliest timestep where anything can change
+void BranchDispatcher::advanceClock()
+{
+	int next = trace.nextTime(cursor);
+	for (int b = 0; b < branchCount; b++)
+		if (wakeTime[b] >= 0 && (next < 0 || wakeTime[b] < next))
+			next = wakeTime[b];
+
+	if (next < 0)
+		finished = true;
+	else
+		currentTime = next;
+}
+
+void BranchDispatcher::work(int worker, Barrier& barrier)
+{
+	int first = (int)((long long)branchCount * worker / threads);
+	int last = (int)((long long)branchCount * (worker + 1) / threads);
+
+	while (true)
+	{
+		if (worker == 0 && !finished)
+			routeEvents();
+		barrier.wait();
+		if (finished)
+			return;
+
+		for (int b = first; b < last; b++)
+		{
+			if (!active[b])
+				continue;
+			branches[b].BillSkippedTimeSteps(currentTime - lastStep[b] - 1);
+			branches[b].SimulateTimeStep(currentTime);
+			pending[b] = branches[b].HasPendingWork();
+			lastStep[b] = currentTime;
+		}
+		barrier.wait();
+
+		if (worker == 0)
+			closing = decideClose();
+		barrier.wait();
+		if (!closing)
+			return;
+
+		for (int b = first; b < last; b++)
+			if (active[b])
+				wakeTime[b] = branches[b].CloseTimeStep(currentTime);
+		barrier.wait();
+
+		if (worker == 0)
+			advanceClock();
+	}
+}
+
+bool BranchDispatcher::run()
+{
+	error.clear();
+	if (!trace.load(inputFile))
+	{
+		error = trace.getError();
+		return false;
+	}
+	for (int b = 0; b < branchCount; b++)
+		branches[b].Configure(trace.getHeader());
+
+	Barrier barrier(threads);
+	std::thread* pool = new std::thread[threads - 1];
+	for (int w = 1; w < threads; w++)
+		pool[w - 1] = std::thread(&BranchDispatcher::work, this, w, std::ref(barrier));
+	work(0, barrier);
+	for (int w = 1; w < threads; w++)
+		pool[w - 1].join();
+	delete[] pool;
+	return true;
+}
+
+bool BranchDispatcher::writeOutputFiles(const std::string& prefix, std::string& failure)
+{
+	for (int b = 0; b < branchCount; b++)
+	{
+		if (!branches[b].WriteOutputFile(prefix + "_" + std::to_string(b + 1) + ".txt"))
+		{
+			failure = branches[b].getLastError();
+			return false;
+		}
+	}
+	return true;
+}
+
+void BranchDispatcher::printSummary(std::ostream& out) const
+{
+	char line[256];
+	out << "Branches: " << branchCount << " (" << threads << " threads, routing: " << rule->getName() << ")\n";
+	snprintf(line, sizeof(line), "%-8s %10s %10s %12s %10s %8s %10s\n",
+		"Branch", "Routed", "Finished", "AvgWait", "AvgServ", "Late", "AutoProm");
+	out << line;
+
+	long long routed = 0, finishedOrders = 0, late = 0, promoted = 0, totalWait = 0;
+	double totalServ = 0.0;
+	for (int b = 0; b < branchCount; b++)
+	{
+		SimSummary s = branches[b].getSummary();
+		snprintf(line, sizeof(line), "%-8d %10d %10d %12.2f %10.2f %8d %10d\n",
+			b + 1, routedTo[b], s.finishedOrders, s.avgWait, s.avgServ, s.lateOrders, s.autoPromoted);
+		out << line;
+
+		routed += routedTo[b];
+		finishedOrders += s.finishedOrders;
+		late += s.lateOrders;
+		promoted += s.autoPromoted;
+		totalWait += s.totalWait;
+		totalServ += s.avgServ * s.finishedOrders;
+	}
+
+	double avgWait = (finishedOrders > 0) ? (double)totalWait / finishedOrders : 0.0;
+	double avgServ = (finishedOrders > 0) ? totalServ / finishedOrders : 0.0;
+	snprintf(line, sizeof(line), "%-8s %10lld %10lld %12.2f %10.2f %8lld %10lld\n",
+		"Total", routed, finishedOrders, avgWait, avgServ, late, promoted);
+	out << line;
+}
@@ -0,0 +1,92 @@
+#ifndef __BRANCH_DISPATCHER_H_
+#define __BRANCH_DISPATCHER_H_
+
+#include <string>
+#include <iosfwd>
+#include "../Rest/Restaurant.h"
+#include "../IO/EventTrace.h"
+#include "RoutingRule.h"
+#include "Barrier.h"
+
+/*
+Multi-branch mode: B Restaurant branches, each staffed like the input file,
+share one stream of orders. The dispatcher sends every arrival to the branch
+its RoutingRule picks; cancellations and promotions follow their order.
+
+All branches share one clock, which jumps to the earliest timestep where
+the next event or any branch can change. A branch only runs the timesteps
+where it gets an event or its own state can change (its wake time), and
+bills the steps in between when it wakes, exactly like the next-event
+jumps of a single silent run. Each timestep runs in phases separated by
+barriers:
+  1. dispatcher (one thread): route the events due now, mark the branches
+     that run this timestep
+  2. workers: SimulateTimeStep on their marked branches
+  3. dispatcher: stop if no events are left and no branch has work
+  4. workers: CloseTimeStep on their marked branches (-> wake time)
+  5. dispatcher: advance the clock
+Branches are split over the threads in contiguous shards. Routing only
+happens in phase 1, so the results do not depend on the thread count, and
+one branch gives the same report as restaurant_batch.
+
+Complexity per timestep: O(B / threads) per worker plus the work of the
+marked branches, O(B) for the dispatcher and per routed arrival
+*/
+class BranchDispatcher
+{
+	std::string inputFile;
+	int branchCount;
+	int threads;
+	RoutingRule* rule;
+
+	EventTrace trace;
+	EventTrace::Cursor cursor;
+	Restaurant* branches;
+	BranchLoad* loads;			// refreshed at every timestep with arrivals
+	bool* active;				// runs the current timestep
+	bool* pending;				// HasPendingWork after the branch's last timestep
+	int* wakeTime;				// CloseTimeStep of its last timestep (-1: never by itself)
+	int* lastStep;				// last timestep the branch ran
+	int* routedTo;				// per branch: orders routed
+
+	// Order ID -> branch (open addressing, never shrinks)
+	int* mapID;
+	int* mapBranch;
+	int mapCapacity;
+	int mapCount;
+
+	std::string error;
+
+	// Shared between the phases
+	int currentTime;
+	bool closing;
+	bool finished;
+
+	void remember(int orderID, int branch);
+	int branchOf(int orderID) const;
+	void routeEvents();
+	bool decideClose();
+	void advanceClock();
+	void work(int worker, Barrier& barrier);
+
+public:
+	BranchDispatcher(const std::string& input, int branchCount, int threadCount, RoutingRule* routing);
+	~BranchDispatcher();
+
+	BranchDispatcher(const BranchDispatcher&) = delete;
+	BranchDispatcher& operator=(const BranchDispatcher&) = delete;
+
+	// Loads the input and simulates all branches; false on input errors
+	bool run();
+
+	// Branch b's report goes to <prefix>_<b + 1>.txt; false if one fails
+	bool writeOutputFiles(const std::string& prefix, std::string& error);
+
+	// Per-branch headline numbers and their totals (in branch order)
+	void printSummary(std::ostream& out) const;
+
+	const std::string& getError() const { return error; }
+	int getThreads() const { return threads; }
+};
+
+#endif
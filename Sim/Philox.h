@@ -0,0 +1,60 @@
+#ifndef __PHILOX_H_
+#define __PHILOX_H_
+
+#include <cstdint>
+
+/*
+Philox4x32-10 counter-based random number generator (Salmon et al., SC'11)
+
+A random block is a pure function of (key, counter): there is no state to
+advance, so the value drawn for "cook c at timestep t" is the same whatever
+order the simulation asks in, and independent streams only need different
+keys. The key is (seed, stream), e.g. one stream per replication.
+*/
+class Philox4x32
+{
+	uint32_t key0, key1;
+
+	static void mulhilo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo)
+	{
+		uint64_t product = (uint64_t)a * b;
+		hi = (uint32_t)(product >> 32);
+		lo = (uint32_t)product;
+	}
+
+public:
+	Philox4x32(uint32_t seed = 0, uint32_t stream = 0)
+		: key0(seed), key1(stream)
+	{
+	}
+
+	// Four independent 32-bit words for the 128-bit counter (c0..c3)
+	void generate(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t out[4]) const
+	{
+		uint32_t k0 = key0, k1 = key1;
+		for (int round = 0; round < 10; round++)
+		{
+			uint32_t hi0, lo0, hi1, lo1;
+			mulhilo(0xD2511F53u, c0, hi0, lo0);
+			mulhilo(0xCD9E8D57u, c2, hi1, lo1);
+			c0 = hi1 ^ c1 ^ k0;
+			c1 = lo1;
+			c2 = hi0 ^ c3 ^ k1;
+			c3 = lo0;
+			k0 += 0x9E3779B9u;
+			k1 += 0xBB67AE85u;
+		}
+		out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+	}
+
+	// Uniform double in [0, 1) for the counter (c0, c1, c2)
+	double uniform(uint32_t c0, uint32_t c1, uint32_t c2) const
+	{
+		uint32_t r[4];
+		generate(c0, c1, c2, 0, r);
+		uint64_t bits = ((uint64_t)(r[0] >> 5) << 26) | (r[1] >> 6);	// 53 bits
+		return (double)bits * (1.0 / 9007199254740992.0);
+	}
+};
+
+#endif
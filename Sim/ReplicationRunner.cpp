@@ -0,0 +1,150 @@
+#include "ReplicationRunner.h"
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <ostream>
+
+// Two-sided 95% Student t quantiles for 1..30 degrees of freedom
+static const double TQuantile95[] = {
+	12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+	2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+	2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+static double tQuantile95(int degrees)
+{
+	if (degrees <= 0) return 0.0;
+	if (degrees <= 30) return TQuantile95[degrees - 1];
+	if (degrees <= 60) return 2.000;
+	if (degrees <= 120) return 1.980;
+	return 1.960;
+}
+
+ReplicationRunner::ReplicationRunner(const std::string& input, int count, int threadCount, uint32_t rngSeed)
+	: inputFile(input), replications(count > 0 ? count : 1), threads(threadCount), seed(rngSeed)
+{
+	if (threads <= 0)
+		threads = (int)std::thread::hardware_concurrency();
+	if (threads <= 0)
+		threads = 1;
+	if (threads > replications)
+		threads = replications;
+
+	results = new SimSummary[replications];
+	errors = new std::string[replications];
+}
+
+ReplicationRunner::~ReplicationRunner()
+{
+	delete[] results;
+	delete[] errors;
+}
+
+void ReplicationRunner::runOne(int r)
+{
+	Restaurant* pRest = new Restaurant;
+	pRest->setRandomInjuries(true, seed, (uint32_t)r);
+	pRest->LoadTrace(trace, trace.getHeader());
+
+	if (pRest->SimulateWithoutReport())
+		results[r] = pRest->getSummary();
+	else
+		errors[r] = "replication " + std::to_string(r) + ": " + pRest->getLastError();
+
+	delete pRest;
+}
+
+bool ReplicationRunner::run()
+{
+	if (!trace.load(inputFile))
+	{
+		error = trace.getError();
+		return false;
+	}
+
+	std::atomic<int> next(0);
+
+	auto worker = [this, &next]() {
+		int r;
+		while ((r = next.fetch_add(1)) < replications)
+			runOne(r);
+	};
+
+	std::thread* pool = new std::thread[threads - 1];
+	for (int i = 0; i < threads - 1; i++)
+		pool[i] = std::thread(worker);
+	worker();	// the calling thread works too
+	for (int i = 0; i < threads - 1; i++)
+		pool[i].join();
+	delete[] pool;
+
+	error.clear();
+	for (int r = 0; r < replications; r++)
+	{
+		if (!errors[r].empty())
+		{
+			error = errors[r];
+			return false;
+		}
+	}
+	return true;
+}
+
+MetricStats ReplicationRunner::getStats(double (*field)(const SimSummary&)) const
+{
+	MetricStats stats;
+	double sum = 0.0;
+	stats.min = stats.max = field(results[0]);
+	for (int r = 0; r < replications; r++)
+	{
+		double v = field(results[r]);
+		sum += v;
+		if (v < stats.min) stats.min = v;
+		if (v > stats.max) stats.max = v;
+	}
+	stats.mean = sum / replications;
+
+	double squares = 0.0;
+	for (int r = 0; r < replications; r++)
+	{
+		double d = field(results[r]) - stats.mean;
+		squares += d * d;
+	}
+	stats.stdDev = (replications > 1) ? std::sqrt(squares / (replications - 1)) : 0.0;
+	stats.ciHalf = tQuantile95(replications - 1) * stats.stdDev / std::sqrt((double)replications);
+	return stats;
+}
+
+static double AvgWaitOf(const SimSummary& s) { return s.avgWait; }
+static double AvgServOf(const SimSummary& s) { return s.avgServ; }
+static double LateOf(const SimSummary& s) { return s.lateOrders; }
+static double AutoPromotedOf(const SimSummary& s) { return s.autoPromoted; }
+static double FinishedOf(const SimSummary& s) { return s.finishedOrders; }
+
+void ReplicationRunner::printTable(std::ostream& out) const
+{
+	struct Row { const char* name; double (*field)(const SimSummary&); };
+	const Row rows[] = {
+		{ "Avg Wait", AvgWaitOf },
+		{ "Avg Serv", AvgServOf },
+		{ "Late Orders", LateOf },
+		{ "Auto-promoted", AutoPromotedOf },
+		{ "Finished Orders", FinishedOf },
+	};
+
+	char line[256];
+	out << "Replications: " << replications << " (" << threads << " threads, seed " << seed << ")\n";
+	snprintf(line, sizeof(line), "%-16s %12s %12s %25s %12s %12s\n",
+		"Metric", "Mean", "StdDev", "95% CI", "Min", "Max");
+	out << line;
+	for (const Row& row : rows)
+	{
+		MetricStats st = getStats(row.field);
+		char ci[64];
+		snprintf(ci, sizeof(ci), "[%.2f, %.2f]", st.mean - st.ciHalf, st.mean + st.ciHalf);
+		snprintf(line, sizeof(line), "%-16s %12.2f %12.2f %25s %12.2f %12.2f\n",
+			row.name, st.mean, st.stdDev, ci, st.min, st.max);
+		out << line;
+	}
+}
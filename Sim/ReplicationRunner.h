@@ -0,0 +1,65 @@
+#ifndef __REPLICATION_RUNNER_H_
+#define __REPLICATION_RUNNER_H_
+
+#include <string>
+#include <iosfwd>
+#include <cstdint>
+#include "../Rest/Restaurant.h"
+#include "../IO/EventTrace.h"
+
+// Mean and spread of one metric over all replications
+struct MetricStats
+{
+	double mean;
+	double stdDev;		// sample standard deviation
+	double ciHalf;		// half width of the 95% confidence interval of the mean
+	double min, max;
+};
+
+/*
+Monte Carlo replications of one input: K independent Restaurant runs with
+random injuries, replication r drawing from Philox stream (seed, r).
+The input is parsed once; all replications replay the same EventTrace.
+
+Replications are spread over a pool of worker threads; each worker takes
+the next replication number until none are left. Results are stored by
+replication number, so the tables do not depend on the thread count.
+*/
+class ReplicationRunner
+{
+	std::string inputFile;
+	int replications;
+	int threads;
+	uint32_t seed;
+
+	EventTrace trace;
+
+	SimSummary* results;
+	std::string* errors;	// per replication, empty if it succeeded
+	std::string error;		// first failure (by replication number)
+
+	void runOne(int r);
+
+public:
+	ReplicationRunner(const std::string& input, int count, int threadCount, uint32_t rngSeed);
+	~ReplicationRunner();
+
+	ReplicationRunner(const ReplicationRunner&) = delete;
+	ReplicationRunner& operator=(const ReplicationRunner&) = delete;
+
+	// Loads the input and runs all replications; false if any of them failed
+	bool run();
+
+	const SimSummary& getResult(int r) const { return results[r]; }
+	int getCount() const { return replications; }
+	int getThreads() const { return threads; }
+	const std::string& getError() const { return error; }
+
+	// Statistics of field(result) over all replications
+	MetricStats getStats(double (*field)(const SimSummary&)) const;
+
+	// Mean / std dev / 95% CI table of the report's headline numbers
+	void printTable(std::ostream& out) const;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "RoutingRule.h"
+
+RoutingRule* RoutingRule::Create(const std::string& name)
+{
+	if (name == "queue") return new LeastQueueRule;
+	if (name == "wait") return new LeastExpectedWaitRule;
+	if (name == "rr") return new RoundRobinRule;
+	return nullptr;
+}
+
+// Complexity: O(B)
+int LeastQueueRule::Route(const EventRecord&, const BranchLoad* loads, int branchCount)
+{
+	int best = 0;
+	for (int b = 1; b < branchCount; b++)
+	{
+		const BranchLoad& l = loads[b];
+		if (l.waitingOrders < loads[best].waitingOrders ||
+			(l.waitingOrders == loads[best].waitingOrders && l.freeCooks > loads[best].freeCooks))
+			best = b;
+	}
+	return best;
+}
+
+static double ExpectedWait(const BranchLoad& load)
+{
+	if (load.cooks == 0)
+		return 1e300;	// never served
+	int ahead = load.waitingOrders + 1 - load.freeCooks;
+	if (ahead <= 0)
+		return 0.0;
+	double serviceTime = (load.avgServ > 0.0) ? load.avgServ : 1.0;
+	return ahead * serviceTime / load.cooks;
+}
+
+// Complexity: O(B)
+int LeastExpectedWaitRule::Route(const EventRecord&, const BranchLoad* loads, int branchCount)
+{
+	int best = 0;
+	double bestWait = ExpectedWait(loads[0]);
+	for (int b = 1; b < branchCount; b++)
+	{
+		double wait = ExpectedWait(loads[b]);
+		if (wait < bestWait)
+		{
+			bestWait = wait;
+			best = b;
+		}
+	}
+	return best;
+}
+
+int RoundRobinRule::Route(const EventRecord&, const BranchLoad*, int branchCount)
+{
+	int b = next;
+	next = (next + 1) % branchCount;
+	return b;
+}
@@ -0,0 +1,51 @@
+#ifndef __ROUTING_RULE_H_
+#define __ROUTING_RULE_H_
+
+#include <string>
+#include "../Rest/Restaurant.h"
+#include "../Events/EventRecord.h"
+
+// Picks the branch an arriving order goes to (multi-branch mode)
+// Rules see the load of every branch at the order's arrival; equal choices
+// must go to the lowest branch number so runs are reproducible.
+class RoutingRule
+{
+public:
+	virtual ~RoutingRule() {}
+
+	virtual int Route(const EventRecord& arrival, const BranchLoad* loads, int branchCount) = 0;
+	virtual const char* getName() const = 0;
+
+	// "queue", "wait" or "rr" (nullptr for an unknown name)
+	static RoutingRule* Create(const std::string& name);
+};
+
+// Fewest waiting orders (then most free cooks)
+class LeastQueueRule : public RoutingRule
+{
+public:
+	int Route(const EventRecord& arrival, const BranchLoad* loads, int branchCount) override;
+	const char* getName() const override { return "least queue length"; }
+};
+
+// Least expected wait: orders that cannot start now, times the branch's
+// average service time, spread over its cooks
+class LeastExpectedWaitRule : public RoutingRule
+{
+public:
+	int Route(const EventRecord& arrival, const BranchLoad* loads, int branchCount) override;
+	const char* getName() const override { return "least expected wait"; }
+};
+
+// Branches in turn, ignoring the load
+class RoundRobinRule : public RoutingRule
+{
+	int next;
+
+public:
+	RoundRobinRule() : next(0) {}
+	int Route(const EventRecord& arrival, const BranchLoad* loads, int branchCount) override;
+	const char* getName() const override { return "round robin"; }
+};
+
+#endif
@@ -0,0 +1,325 @@
+#include "StaffingSweep.h"
+#include "WorkStealingPool.h"
+#include "../Rest/RunMonitor.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <ostream>
+
+// Field of TraceHeader behind each SWEEP_PARAM
+static int TraceHeader::* const ParamField[PARAM_CNT] = {
+	&TraceHeader::N, &TraceHeader::G, &TraceHeader::V,
+	&TraceHeader::SN, &TraceHeader::SG, &TraceHeader::SV,
+	&TraceHeader::BO, &TraceHeader::BN, &TraceHeader::BG, &TraceHeader::BV,
+	&TraceHeader::AutoP
+};
+
+static const char* const ParamNames[PARAM_CNT] = {
+	"N", "G", "V", "SN", "SG", "SV", "BO", "BN", "BG", "BV", "AutoP"
+};
+
+const char* StaffingSweep::ParamName(SWEEP_PARAM param)
+{
+	return ParamNames[param];
+}
+
+// Asks the sweep every few timesteps whether the run can still pay off
+class SweepMonitor : public RunMonitor
+{
+	StaffingSweep* sweep;
+	int config;
+
+public:
+	CONFIG_STATUS reason;
+
+	SweepMonitor(StaffingSweep* owner, int c)
+		: sweep(owner), config(c), reason(CFG_DONE)
+	{
+	}
+
+	bool KeepRunning(const Restaurant& rest, int) override
+	{
+		return sweep->keepRunning(config, rest.getSummary(), reason);
+	}
+};
+
+StaffingSweep::StaffingSweep(const std::string& input, int threadCount)
+	: inputFile(input), cookCost(1.0), speedCost(0.0), maxLatePercent(-1.0),
+	  pruning(true), threads(threadCount), lateLimit(LLONG_MAX), configCount(0),
+	  configs(nullptr), costs(nullptr), results(nullptr), status(nullptr),
+	  frontier(nullptr), frontierCount(0), elapsed(0.0)
+{
+	for (int p = 0; p < PARAM_CNT; p++)
+		rangeSet[p] = false;
+}
+
+StaffingSweep::~StaffingSweep()
+{
+	delete[] configs;
+	delete[] costs;
+	delete[] results;
+	delete[] status;
+	delete[] frontier;
+}
+
+void StaffingSweep::setRange(SWEEP_PARAM param, const ParamRange& range)
+{
+	ranges[param] = range;
+	rangeSet[param] = true;
+}
+
+void StaffingSweep::setCosts(double perCook, double perSpeedUnit)
+{
+	cookCost = perCook;
+	speedCost = perSpeedUnit;
+}
+
+void StaffingSweep::setMaxLatePercent(double percent)
+{
+	maxLatePercent = percent;
+}
+
+double StaffingSweep::costOf(const TraceHeader& h) const
+{
+	return h.N * (cookCost + speedCost * h.SN)
+		+ h.G * (cookCost + speedCost * h.SG)
+		+ h.V * (cookCost + speedCost * h.SV);
+}
+
+// Every combination of the ranges, cheapest first (ties in grid order)
+bool StaffingSweep::buildGrid()
+{
+	const TraceHeader& base = trace.getHeader();
+	int values[PARAM_CNT];
+	long long total = 1;
+	for (int p = 0; p < PARAM_CNT; p++)
+	{
+		if (!rangeSet[p])
+		{
+			int v = base.*ParamField[p];
+			ranges[p].first = ranges[p].last = v;
+			ranges[p].step = 1;
+		}
+		const ParamRange& r = ranges[p];
+		bool isSpeed = (p == PARAM_SN || p == PARAM_SG || p == PARAM_SV);
+		if (r.step <= 0 || r.last < r.first || r.first < (isSpeed ? 1 : 0))
+		{
+			error = std::string("Invalid range for ") + ParamNames[p];
+			return false;
+		}
+		values[p] = (r.last - r.first) / r.step + 1;
+		total *= values[p];
+		if (total > MaxConfigs)
+		{
+			error = "Too many configurations (more than " + std::to_string(MaxConfigs) + ")";
+			return false;
+		}
+	}
+
+	configCount = (int)total;
+	TraceHeader* grid = new TraceHeader[configCount];
+	for (int c = 0; c < configCount; c++)
+	{
+		grid[c] = base;
+		int rest = c;
+		for (int p = PARAM_CNT - 1; p >= 0; p--)
+		{
+			grid[c].*ParamField[p] = ranges[p].first + (rest % values[p]) * ranges[p].step;
+			rest /= values[p];
+		}
+	}
+
+	double* gridCost = new double[configCount];
+	int* order = new int[configCount];
+	for (int c = 0; c < configCount; c++)
+	{
+		gridCost[c] = costOf(grid[c]);
+		order[c] = c;
+	}
+	std::stable_sort(order, order + configCount,
+		[gridCost](int a, int b) { return gridCost[a] < gridCost[b]; });
+
+	configs = new TraceHeader[configCount];
+	costs = new double[configCount];
+	results = new SimSummary[configCount];
+	status = new CONFIG_STATUS[configCount];
+	frontier = new int[configCount];
+	for (int c = 0; c < configCount; c++)
+	{
+		configs[c] = grid[order[c]];
+		costs[c] = gridCost[order[c]];
+		status[c] = CFG_PENDING;
+	}
+	delete[] grid;
+	delete[] gridCost;
+	delete[] order;
+	return true;
+}
+
+bool StaffingSweep::run()
+{
+	auto start = std::chrono::steady_clock::now();
+	error.clear();
+	if (!trace.load(inputFile))
+	{
+		error = trace.getError();
+		return false;
+	}
+	if (!buildGrid())
+		return false;
+
+	if (maxLatePercent >= 0.0)
+		lateLimit = (long long)std::floor(maxLatePercent / 100.0 * trace.getArrivalCount());
+
+	WorkStealingPool pool(threads);
+	threads = pool.getThreads();
+	pool.run(configCount, [this](int c) { runOne(c); });
+
+	elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return true;
+}
+
+void StaffingSweep::runOne(int c)
+{
+	Restaurant* pRest = new Restaurant;
+	pRest->LoadTrace(trace, configs[c]);
+
+	SweepMonitor monitor(this, c);
+	bool finished = pRest->SimulateWithoutReport(pruning ? &monitor : nullptr);
+	results[c] = pRest->getSummary();
+	delete pRest;
+
+	if (!finished)
+	{
+		status[c] = monitor.reason;
+		return;
+	}
+	if (results[c].pendingOrders > 0)
+	{
+		status[c] = CFG_UNSERVED;
+		return;
+	}
+	status[c] = CFG_DONE;
+	if (results[c].lateOrders <= lateLimit)
+		addToFrontier(c);
+}
+
+// Does finished configuration d dominate (cost, late, wait)? With partial
+// values late and wait are lower bounds, so d must not be worse than them
+bool StaffingSweep::dominates(int d, double cost, long long late, double wait) const
+{
+	const SimSummary& r = results[d];
+	if (costs[d] > cost || r.lateOrders > late || r.avgWait > wait)
+		return false;
+	if (costs[d] < cost || r.lateOrders < late || r.avgWait < wait)
+		return true;
+	return false;	// equal in all three: neither dominates
+}
+
+void StaffingSweep::addToFrontier(int c)
+{
+	const SimSummary& r = results[c];
+	std::lock_guard<std::mutex> guard(frontierLock);
+	for (int i = 0; i < frontierCount; i++)
+	{
+		if (dominates(frontier[i], costs[c], r.lateOrders, r.avgWait))
+			return;
+	}
+
+	int kept = 0;
+	for (int i = 0; i < frontierCount; i++)
+	{
+		const SimSummary& other = results[frontier[i]];
+		if (!dominates(c, costs[frontier[i]], other.lateOrders, other.avgWait))
+			frontier[kept++] = frontier[i];
+	}
+	frontier[kept++] = c;
+	frontierCount = kept;
+}
+
+bool StaffingSweep::keepRunning(int c, const SimSummary& partial, CONFIG_STATUS& reason)
+{
+	if (partial.lateOrders > lateLimit)
+	{
+		reason = CFG_PRUNED_LATE;
+		return false;
+	}
+
+	double waitBound = (double)partial.totalWait / std::max(trace.getArrivalCount(), 1);
+	std::lock_guard<std::mutex> guard(frontierLock);
+	for (int i = 0; i < frontierCount; i++)
+	{
+		if (dominates(frontier[i], costs[c], partial.lateOrders, waitBound))
+		{
+			reason = CFG_PRUNED_DOMINATED;
+			return false;
+		}
+	}
+	return true;
+}
+
+int StaffingSweep::getCount(CONFIG_STATUS st) const
+{
+	int count = 0;
+	for (int c = 0; c < configCount; c++)
+		if (status[c] == st)
+			count++;
+	return count;
+}
+
+void StaffingSweep::printReport(std::ostream& out) const
+{
+	// Frontier by cost, then by grid position (independent of thread timing)
+	int* rows = new int[frontierCount];
+	for (int i = 0; i < frontierCount; i++)
+		rows[i] = frontier[i];
+	std::sort(rows, rows + frontierCount);
+
+	int done = getCount(CFG_DONE);
+	int overLimit = 0;
+	for (int c = 0; c < configCount; c++)
+		if (status[c] == CFG_DONE && results[c].lateOrders > lateLimit)
+			overLimit++;
+
+	char line[256];
+	out << "Configurations: " << configCount << " (" << threads << " threads)\n";
+	out << "  simulated to the end:  " << done;
+	if (overLimit > 0)
+		out << " (" << overLimit << " over the late limit)";
+	out << "\n";
+	out << "  left orders unserved:  " << getCount(CFG_UNSERVED) << "\n";
+	out << "  pruned as dominated:   " << getCount(CFG_PRUNED_DOMINATED) << "\n";
+	out << "  pruned as too late:    " << getCount(CFG_PRUNED_LATE) << "\n";
+	if (lateLimit != LLONG_MAX)
+		out << "Late limit: " << lateLimit << " of " << trace.getArrivalCount() << " orders\n";
+
+	out << "Pareto frontier (" << frontierCount << "):\n";
+	snprintf(line, sizeof(line), "%10s", "Cost");
+	out << line;
+	for (int p = 0; p < PARAM_CNT; p++)
+	{
+		snprintf(line, sizeof(line), " %5s", ParamNames[p]);
+		out << line;
+	}
+	snprintf(line, sizeof(line), " %10s %8s %10s\n", "AvgWait", "Late", "Finished");
+	out << line;
+
+	for (int i = 0; i < frontierCount; i++)
+	{
+		int c = rows[i];
+		snprintf(line, sizeof(line), "%10.2f", costs[c]);
+		out << line;
+		for (int p = 0; p < PARAM_CNT; p++)
+		{
+			snprintf(line, sizeof(line), " %5d", configs[c].*ParamField[p]);
+			out << line;
+		}
+		snprintf(line, sizeof(line), " %10.2f %8d %10d\n",
+			results[c].avgWait, results[c].lateOrders, results[c].finishedOrders);
+		out << line;
+	}
+	out << "Elapsed: " << elapsed << " s\n";
+	delete[] rows;
+}
@@ -0,0 +1,120 @@
+#ifndef __STAFFING_SWEEP_H_
+#define __STAFFING_SWEEP_H_
+
+#include <string>
+#include <iosfwd>
+#include <mutex>
+#include "../Rest/Restaurant.h"
+#include "../IO/EventTrace.h"
+
+// The input parameters a sweep can vary
+enum SWEEP_PARAM
+{
+	PARAM_N, PARAM_G, PARAM_V,
+	PARAM_SN, PARAM_SG, PARAM_SV,
+	PARAM_BO, PARAM_BN, PARAM_BG, PARAM_BV,
+	PARAM_AUTOP,
+	PARAM_CNT
+};
+
+// first, first + step, ... up to last
+struct ParamRange
+{
+	int first, last, step;
+};
+
+enum CONFIG_STATUS
+{
+	CFG_PENDING,
+	CFG_DONE,				// simulated to the end
+	CFG_UNSERVED,			// simulated to the end, but some orders were never served
+	CFG_PRUNED_DOMINATED,	// stopped: a finished cheaper configuration is better
+	CFG_PRUNED_LATE			// stopped: too many late orders already
+};
+
+/*
+Staffing optimizer: simulates every combination of the parameter ranges on
+one input file (parsed once, shared read-only by all runs) and reports the
+Pareto frontier of cost against average wait and late orders.
+
+Cost = sum over cook types of count * (cookCost + speedCost * speed).
+Configurations run cheapest first on a work-stealing pool. A run is cut
+short as soon as its partial results prove it cannot reach the frontier:
+  - late orders so far exceed the late limit (late orders only grow), or
+  - a finished configuration D with cost_D <= cost has late_D <= late so far
+    and avgWait_D <= wait so far / arrivals (a lower bound of the final
+    average), one of them strictly.
+Pruned runs are dominated by a finished one, so the frontier is the same
+as without pruning.
+
+A configuration that leaves orders unserved (too few cooks of a type for
+its orders, e.g. no Vegan cook) is infeasible and never on the frontier:
+its wait and late figures only cover the orders it did serve.
+*/
+class StaffingSweep
+{
+public:
+	static const int MaxConfigs = 1000000;
+
+private:
+	std::string inputFile;
+	ParamRange ranges[PARAM_CNT];
+	bool rangeSet[PARAM_CNT];
+	double cookCost, speedCost;
+	double maxLatePercent;		// < 0: no limit
+	bool pruning;
+	int threads;
+
+	EventTrace trace;
+	long long lateLimit;		// late orders allowed (LLONG_MAX: no limit)
+
+	int configCount;
+	TraceHeader* configs;		// sorted by cost
+	double* costs;
+	SimSummary* results;		// valid for CFG_DONE
+	CONFIG_STATUS* status;
+
+	// Finished feasible configurations no other one dominates
+	std::mutex frontierLock;
+	int* frontier;
+	int frontierCount;
+
+	std::string error;
+	double elapsed;
+
+	bool buildGrid();
+	double costOf(const TraceHeader& h) const;
+	void runOne(int c);
+	void addToFrontier(int c);
+	bool dominates(int d, double cost, long long late, double wait) const;
+
+	friend class SweepMonitor;
+	bool keepRunning(int c, const SimSummary& partial, CONFIG_STATUS& reason);
+
+public:
+	StaffingSweep(const std::string& input, int threadCount);
+	~StaffingSweep();
+
+	StaffingSweep(const StaffingSweep&) = delete;
+	StaffingSweep& operator=(const StaffingSweep&) = delete;
+
+	// Unset parameters keep the input file's value
+	void setRange(SWEEP_PARAM param, const ParamRange& range);
+	void setCosts(double perCook, double perSpeedUnit);
+	void setMaxLatePercent(double percent);
+	void setPruning(bool enabled) { pruning = enabled; }
+
+	// Loads the input and runs every configuration; false on input errors
+	bool run();
+	const std::string& getError() const { return error; }
+
+	int getConfigCount() const { return configCount; }
+	int getCount(CONFIG_STATUS st) const;
+
+	// Frontier table (by cost) and the counts of evaluated / pruned runs
+	void printReport(std::ostream& out) const;
+
+	static const char* ParamName(SWEEP_PARAM param);
+};
+
+#endif
@@ -0,0 +1,88 @@
+#include "WorkStealingPool.h"
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+	: threads(threadCount)
+{
+	if (threads <= 0)
+		threads = (int)std::thread::hardware_concurrency();
+	if (threads <= 0)
+		threads = 1;
+	slices = new Slice[threads];
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	delete[] slices;
+}
+
+// Worker w owns [w * count / threads, (w + 1) * count / threads)
+void WorkStealingPool::split(int count)
+{
+	for (int w = 0; w < threads; w++)
+	{
+		slices[w].begin = (int)((long long)count * w / threads);
+		slices[w].end = (int)((long long)count * (w + 1) / threads);
+	}
+}
+
+bool WorkStealingPool::take(int worker, int& index)
+{
+	Slice& own = slices[worker];
+	{
+		std::lock_guard<std::mutex> guard(own.lock);
+		if (own.begin < own.end)
+		{
+			index = own.begin++;
+			return true;
+		}
+	}
+
+	// Steal: a size may change once its lock is released, so the victim is
+	// re-checked when it is locked again
+	while (true)
+	{
+		int victim = -1;
+		int largest = 0;
+		for (int w = 0; w < threads; w++)
+		{
+			if (w == worker)
+				continue;
+			int size;
+			{
+				std::lock_guard<std::mutex> guard(slices[w].lock);
+				size = slices[w].end - slices[w].begin;
+			}
+			if (size > largest)
+			{
+				largest = size;
+				victim = w;
+			}
+		}
+		if (victim < 0)
+			return false;
+
+		int stolenBegin, stolenEnd;
+		{
+			std::lock_guard<std::mutex> guard(slices[victim].lock);
+			Slice& v = slices[victim];
+			int size = v.end - v.begin;
+			if (size <= 0)
+				continue;
+			int half = size / 2;	// the victim keeps the front half (and a lone index)
+			if (half == 0)
+			{
+				index = --v.end;
+				return true;
+			}
+			stolenBegin = v.end - half;
+			stolenEnd = v.end;
+			v.end = stolenBegin;
+		}
+
+		std::lock_guard<std::mutex> guard(own.lock);
+		index = stolenBegin;
+		own.begin = stolenBegin + 1;
+		own.end = stolenEnd;
+		return true;
+	}
+}
@@ -0,0 +1,60 @@
+#ifndef __WORK_STEALING_POOL_H_
+#define __WORK_STEALING_POOL_H_
+
+#include <thread>
+#include <mutex>
+
+/*
+Runs task(i) for every i in [0, count) on a fixed number of threads.
+
+Every worker starts with its own contiguous slice of the index range and
+takes indices from the front of it, in order. A worker whose slice is empty
+steals the back half of the largest slice left, so uneven task lengths
+(short and long simulations) do not leave threads idle at the end.
+
+Complexity: take -> O(1) from the own slice, O(threads) for a steal
+*/
+class WorkStealingPool
+{
+	struct Slice {
+		int begin, end;		// indices not taken yet: [begin, end)
+		std::mutex lock;
+	};
+
+	Slice* slices;
+	int threads;
+
+	void split(int count);
+	bool take(int worker, int& index);
+
+public:
+	explicit WorkStealingPool(int threadCount);
+	~WorkStealingPool();
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	int getThreads() const { return threads; }
+
+	// Returns once every task has run; the calling thread works too
+	template <typename Task>
+	void run(int count, Task task)
+	{
+		split(count);
+		auto worker = [this, &task](int w) {
+			int index;
+			while (take(w, index))
+				task(index);
+		};
+
+		std::thread* pool = new std::thread[threads - 1];
+		for (int w = 1; w < threads; w++)
+			pool[w - 1] = std::thread(worker, w);
+		worker(0);
+		for (int w = 1; w < threads; w++)
+			pool[w - 1].join();
+		delete[] pool;
+	}
+};
+
+#endif
@@ -0,0 +1,449 @@
+#include "WorkloadGenerator.h"
+#include "../IO/OutputBuffer.h"
+#include "../Generic_DS/HandleHeap.h"
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <climits>
+
+// Output bytes per write
+static const size_t FlushSize = 1 << 20;
+
+// Timesteps stay well inside an int (the parser and the simulation use int)
+static const double MaxTime = 2000000000.0;
+
+// At most n numbers separated by ':'; returns how many were read (-1 if malformed)
+static int ParseNumbers(const char* text, double* values, int n)
+{
+	int count = 0;
+	const char* p = text;
+	while (count < n)
+	{
+		char* end;
+		values[count] = strtod(p, &end);
+		if (end == p)
+			return -1;
+		count++;
+		if (*end == '\0')
+			return count;
+		if (*end != ':')
+			return -1;
+		p = end + 1;
+	}
+	return -1;
+}
+
+// Exactly n non-negative integers separated by ':'
+static bool ParseInts(const char* text, int* values, int n)
+{
+	double numbers[8];
+	if (n > 8 || ParseNumbers(text, numbers, n) != n)
+		return false;
+	for (int i = 0; i < n; i++)
+	{
+		if (numbers[i] < 0 || numbers[i] > INT_MAX || numbers[i] != floor(numbers[i]))
+			return false;
+		values[i] = (int)numbers[i];
+	}
+	return true;
+}
+
+//========================================
+// Distribution
+//========================================
+
+bool Distribution::Parse(const char* text, Distribution& dist)
+{
+	const char* colon = strchr(text, ':');
+	std::string name = colon ? std::string(text, colon - text) : std::string();
+	const char* params = colon ? colon + 1 : text;
+
+	double values[2];
+	int count = ParseNumbers(params, values, 2);
+
+	if (!colon && count == 1)
+	{
+		dist.kind = DIST_CONST;
+		dist.a = dist.b = values[0];
+		return values[0] >= 1;
+	}
+	if (name == "uniform" && count == 2)
+	{
+		dist.kind = DIST_UNIFORM;
+		dist.a = values[0];
+		dist.b = values[1];
+		return values[0] >= 1 && values[0] <= values[1];
+	}
+	if (name == "geometric" && count == 1)
+	{
+		dist.kind = DIST_GEOMETRIC;
+		dist.a = dist.b = values[0];
+		return values[0] >= 1;
+	}
+	if (name == "normal" && count == 2)
+	{
+		dist.kind = DIST_NORMAL;
+		dist.a = values[0];
+		dist.b = values[1];
+		return values[1] >= 0;
+	}
+	return false;
+}
+
+int Distribution::sample(double u1, double u2) const
+{
+	double value = a;
+	switch (kind)
+	{
+	case DIST_CONST:
+		break;
+	case DIST_UNIFORM:
+		value = floor(a) + floor(u1 * (floor(b) - floor(a) + 1));
+		break;
+	case DIST_GEOMETRIC:
+		// Trials up to the first success, success probability 1 / mean
+		if (a > 1)
+			value = 1 + floor(log(1 - u1) / log(1 - 1 / a));
+		break;
+	case DIST_NORMAL:
+		// Box-Muller
+		value = floor(a + b * sqrt(-2 * log(1 - u1)) * cos(6.283185307179586 * u2) + 0.5);
+		break;
+	}
+	if (value < 1) return 1;
+	if (value > 1000000000) return 1000000000;
+	return (int)value;
+}
+
+//========================================
+// WorkloadSpec
+//========================================
+
+WorkloadSpec::WorkloadSpec()
+	: events(1000), seed(1),
+	  rate(1.0), burstFactor(1.0), burstLength(20.0), calmLength(200.0),
+	  cancelRate(0.05), promoteRate(0.05)
+{
+	mix[TYPE_NRM] = 70;
+	mix[TYPE_VGAN] = 20;
+	mix[TYPE_VIP] = 10;
+	Distribution::Parse("uniform:5:30", size);
+	Distribution::Parse("uniform:50:500", money);
+	Distribution::Parse("uniform:1:20", delay);
+	Distribution::Parse("uniform:10:100", extraMoney);
+
+	cooks.N = 5; cooks.G = 3; cooks.V = 2;
+	cooks.SN = 4; cooks.SG = 3; cooks.SV = 5;
+	cooks.BO = 3;
+	cooks.BN = 2; cooks.BG = 3; cooks.BV = 4;
+	cooks.AutoP = 15;
+	cooks.M = 0;
+}
+
+static const char* const OptionNames[] = {
+	"events", "seed", "rate", "burst", "mix", "size", "money",
+	"cancel", "promote", "delay", "extra", "cooks", "speeds", "breaks", "autop"
+};
+
+bool WorkloadSpec::IsOption(const std::string& name)
+{
+	for (const char* option : OptionNames)
+		if (name == option)
+			return true;
+	return false;
+}
+
+bool WorkloadSpec::setOption(const std::string& name, const char* value)
+{
+	double numbers[3];
+	int ints[4];
+
+	if (name == "events")
+	{
+		if (!ParseInts(value, ints, 1) || ints[0] < 1) return false;
+		events = ints[0];
+	}
+	else if (name == "seed")
+	{
+		char* end;
+		unsigned long s = strtoul(value, &end, 10);
+		if (end == value || *end != '\0') return false;
+		seed = (uint32_t)s;
+	}
+	else if (name == "rate")
+	{
+		if (ParseNumbers(value, numbers, 1) != 1 || !(numbers[0] > 0)) return false;
+		rate = numbers[0];
+	}
+	else if (name == "burst")
+	{
+		if (ParseNumbers(value, numbers, 3) != 3 || !(numbers[0] > 0) ||
+			!(numbers[1] > 0) || !(numbers[2] > 0))
+			return false;
+		burstFactor = numbers[0];
+		burstLength = numbers[1];
+		calmLength = numbers[2];
+	}
+	else if (name == "mix")
+	{
+		if (ParseNumbers(value, numbers, 3) != 3) return false;
+		for (int i = 0; i < TYPE_CNT; i++)
+		{
+			if (!(numbers[i] >= 0)) return false;
+			mix[i] = numbers[i];
+		}
+	}
+	else if (name == "size") return Distribution::Parse(value, size);
+	else if (name == "money") return Distribution::Parse(value, money);
+	else if (name == "delay") return Distribution::Parse(value, delay);
+	else if (name == "extra") return Distribution::Parse(value, extraMoney);
+	else if (name == "cancel" || name == "promote")
+	{
+		if (ParseNumbers(value, numbers, 1) != 1 || !(numbers[0] >= 0) || numbers[0] > 1)
+			return false;
+		(name == "cancel" ? cancelRate : promoteRate) = numbers[0];
+	}
+	else if (name == "cooks")
+	{
+		if (!ParseInts(value, ints, 3)) return false;
+		cooks.N = ints[0]; cooks.G = ints[1]; cooks.V = ints[2];
+	}
+	else if (name == "speeds")
+	{
+		if (!ParseInts(value, ints, 3)) return false;
+		cooks.SN = ints[0]; cooks.SG = ints[1]; cooks.SV = ints[2];
+	}
+	else if (name == "breaks")
+	{
+		if (!ParseInts(value, ints, 4)) return false;
+		cooks.BO = ints[0]; cooks.BN = ints[1]; cooks.BG = ints[2]; cooks.BV = ints[3];
+	}
+	else if (name == "autop")
+	{
+		if (!ParseInts(value, ints, 1)) return false;
+		cooks.AutoP = ints[0];
+	}
+	else
+		return false;
+	return true;
+}
+
+const char* WorkloadSpec::OptionsHelp()
+{
+	return
+		"  --events M        event lines (default 1000)\n"
+		"  --seed S          random stream (default 1)\n"
+		"  --rate R          mean arrivals per timestep (default 1)\n"
+		"  --burst F:B:C     bursts of F times the rate, mean length B timesteps,\n"
+		"                    between calm periods of mean length C (default: no bursts)\n"
+		"  --mix N:G:V       weights of the order types (default 70:20:10)\n"
+		"  --size D          dishes per order (default uniform:5:30)\n"
+		"  --money D         order money (default uniform:50:500)\n"
+		"  --cancel P        fraction of Normal orders cancelled later (default 0.05)\n"
+		"  --promote P       fraction of Normal orders promoted later (default 0.05)\n"
+		"  --delay D         timesteps from arrival to cancellation / promotion (default uniform:1:20)\n"
+		"  --extra D         extra money of a promotion (default uniform:10:100)\n"
+		"  --cooks N:G:V     cooks per type (default 5:3:2)\n"
+		"  --speeds SN:SG:SV (default 4:3:5)\n"
+		"  --breaks BO:BN:BG:BV  orders before a break, break durations (default 3:2:3:4)\n"
+		"  --autop A         auto-promotion limit (default 15)\n"
+		"  D: a number, uniform:A:B, geometric:MEAN or normal:MEAN:SD\n";
+}
+
+std::string WorkloadSpec::check() const
+{
+	if (cancelRate + promoteRate > 1)
+		return "cancel + promote fractions exceed 1";
+	if (mix[TYPE_NRM] + mix[TYPE_VGAN] + mix[TYPE_VIP] <= 0)
+		return "the order mix is empty";
+
+	// The simulator rejects (and cannot serve with) cooks of speed 0
+	if ((cooks.N > 0 && cooks.SN < 1) || (cooks.G > 0 && cooks.SG < 1) || (cooks.V > 0 && cooks.SV < 1))
+		return "cook speeds must be at least 1";
+
+	// Orders no cook can take would wait forever
+	if (mix[TYPE_VGAN] > 0 && cooks.G == 0)
+		return "vegan orders need vegan cooks";
+	bool normalOrVIP = cooks.N > 0 || cooks.V > 0;
+	if (mix[TYPE_NRM] + mix[TYPE_VIP] > 0 && !normalOrVIP)
+		return "normal and VIP orders need normal or VIP cooks";
+	return "";
+}
+
+//========================================
+// WorkloadGenerator
+//========================================
+
+namespace
+{
+	// A cancellation or promotion waiting for its timestep
+	struct PendingEvent
+	{
+		char kind;			// 'X' or 'P'
+		int id;
+		int extra;
+	};
+}
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadSpec& s)
+	: spec(s), rng(s.seed, 0), draws(0),
+	  arrivals(0), cancellations(0), promotions(0), lastTime(0)
+{
+}
+
+double WorkloadGenerator::nextUniform()
+{
+	double u = rng.uniform((uint32_t)draws, (uint32_t)(draws >> 32), 0);
+	draws++;
+	return u;
+}
+
+double WorkloadGenerator::nextExponential(double mean)
+{
+	return -mean * log(1 - nextUniform());
+}
+
+bool WorkloadGenerator::write(const std::string& filename)
+{
+	error = spec.check();
+	if (!error.empty())
+		return false;
+
+	std::ofstream out(filename);
+	if (!out.is_open())
+	{
+		error = "Cannot write to " + filename;
+		return false;
+	}
+
+	draws = 0;
+	arrivals = cancellations = promotions = lastTime = 0;
+
+	OutputBuffer buffer(FlushSize + 256);
+	const TraceHeader& h = spec.cooks;
+	int header[] = { h.N, h.G, h.V, h.SN, h.SG, h.SV, h.BO, h.BN, h.BG, h.BV, h.AutoP, spec.events };
+	int lineEnds[] = { 2, 5, 9, 10, 11 };	// last value of each header line
+	for (int i = 0, line = 0; i < 12; i++)
+	{
+		buffer.appendInt(header[i]);
+		bool endOfLine = (i == lineEnds[line]);
+		buffer.append(endOfLine ? '\n' : ' ');
+		if (endOfLine) line++;
+	}
+
+	double mixTotal = spec.mix[TYPE_NRM] + spec.mix[TYPE_VGAN] + spec.mix[TYPE_VIP];
+	double normalShare = spec.mix[TYPE_NRM] / mixTotal;
+	double veganShare = spec.mix[TYPE_VGAN] / mixTotal;
+
+	bool bursty = (spec.burstFactor != 1.0);
+	bool inBurst = false;
+	double clock = 0.0;
+	double phaseEnd = bursty ? nextExponential(spec.calmLength) : HUGE_VAL;
+
+	HandleHeap<PendingEvent, int, 4> pending;
+	int written = 0;
+	while (written < spec.events)
+	{
+		// Next arrival of a Poisson process; at a burst boundary the rate
+		// changes and the (memoryless) gap is drawn again
+		double rate = inBurst ? spec.rate * spec.burstFactor : spec.rate;
+		double next = clock + nextExponential(1.0 / rate);
+		if (next >= phaseEnd)
+		{
+			clock = phaseEnd;
+			inBurst = !inBurst;
+			phaseEnd = clock + nextExponential(inBurst ? spec.burstLength : spec.calmLength);
+			continue;
+		}
+		clock = next;
+		if (clock >= MaxTime)
+		{
+			error = "arrival rate too low: the timesteps would overflow";
+			return false;
+		}
+		int time = (int)clock + 1;
+
+		// Cancellations and promotions due by now come first
+		PendingEvent ev;
+		int due;
+		while (written < spec.events && pending.peek(ev, due) && due <= time)
+		{
+			pending.pop(ev, due);
+			buffer.append(ev.kind);
+			buffer.append(' ');
+			buffer.appendInt(due);
+			buffer.append(' ');
+			buffer.appendInt(ev.id);
+			if (ev.kind == 'P')
+			{
+				buffer.append(' ');
+				buffer.appendInt(ev.extra);
+			}
+			buffer.append('\n');
+			lastTime = due;
+			written++;
+		}
+		if (written == spec.events)
+			break;
+
+		double u = nextUniform();
+		ORD_TYPE type = (u < normalShare) ? TYPE_NRM : (u < normalShare + veganShare) ? TYPE_VGAN : TYPE_VIP;
+		int id = ++arrivals;
+		int dishes = spec.size.sample(nextUniform(), nextUniform());
+		int money = spec.money.sample(nextUniform(), nextUniform());
+
+		buffer.append("R ");
+		buffer.append(type == TYPE_NRM ? 'N' : type == TYPE_VGAN ? 'G' : 'V');
+		buffer.append(' ');
+		buffer.appendInt(time);
+		buffer.append(' ');
+		buffer.appendInt(id);
+		buffer.append(' ');
+		buffer.appendInt(dishes);
+		buffer.append(' ');
+		buffer.appendInt(money);
+		buffer.append('\n');
+		lastTime = time;
+		written++;
+
+		// Only Normal orders can be cancelled or promoted
+		if (type == TYPE_NRM)
+		{
+			double fate = nextUniform();
+			if (fate < spec.cancelRate + spec.promoteRate)
+			{
+				PendingEvent later;
+				later.kind = (fate < spec.cancelRate) ? 'X' : 'P';
+				later.id = id;
+				later.extra = (later.kind == 'P') ? spec.extraMoney.sample(nextUniform(), nextUniform()) : 0;
+				int delay = spec.delay.sample(nextUniform(), nextUniform());
+				pending.push(later, (time < INT_MAX - delay) ? time + delay : INT_MAX);
+				if (later.kind == 'X') cancellations++;
+				else promotions++;
+			}
+		}
+
+		if (buffer.getLength() >= FlushSize)
+			buffer.writeTo(out);
+	}
+
+	// Those still pending did not fit in the M lines
+	while (!pending.isEmpty())
+	{
+		PendingEvent ev;
+		int due;
+		pending.pop(ev, due);
+		if (ev.kind == 'X') cancellations--;
+		else promotions--;
+	}
+
+	buffer.writeTo(out);
+	out.close();
+	if (out.fail())
+	{
+		error = "Cannot write to " + filename;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,106 @@
+#ifndef __WORKLOAD_GENERATOR_H_
+#define __WORKLOAD_GENERATOR_H_
+
+#include <string>
+#include <cstdint>
+#include "../Defs.h"
+#include "../IO/TraceParser.h"
+#include "Philox.h"
+
+enum DIST_KIND
+{
+	DIST_CONST,			// always a
+	DIST_UNIFORM,		// integers a..b
+	DIST_GEOMETRIC,		// mean a
+	DIST_NORMAL			// mean a, standard deviation b (rounded)
+};
+
+// Distribution of an integer quantity of the generated orders
+// Every draw is at least 1
+struct Distribution
+{
+	DIST_KIND kind;
+	double a, b;
+
+	// "5", "uniform:A:B", "geometric:MEAN" or "normal:MEAN:SD"
+	static bool Parse(const char* text, Distribution& dist);
+
+	// u1, u2: independent uniforms in [0, 1)
+	int sample(double u1, double u2) const;
+};
+
+// Everything a generated input file is made of
+struct WorkloadSpec
+{
+	int events;					// event lines (R, X and P together)
+	uint32_t seed;
+
+	// Arrivals: a Poisson process of `rate` orders per timestep, switching to
+	// rate * burstFactor during bursts; burst and calm periods have
+	// exponential lengths of the given means (burstFactor 1: no bursts)
+	double rate;
+	double burstFactor;
+	double burstLength, calmLength;
+
+	double mix[TYPE_CNT];		// relative weights of N, G and V arrivals
+	Distribution size;			// dishes
+	Distribution money;
+
+	// Fractions of the Normal orders that get cancelled / promoted later
+	// (at most one of the two per order), `delay` timesteps after arriving
+	double cancelRate;
+	double promoteRate;
+	Distribution delay;
+	Distribution extraMoney;	// of a promotion
+
+	TraceHeader cooks;			// cooks, breaks and AutoP (M is ignored)
+
+	WorkloadSpec();
+
+	// Command-line options shared by the tools ("rate" for --rate ...)
+	static bool IsOption(const std::string& name);
+	bool setOption(const std::string& name, const char* value);
+	static const char* OptionsHelp();
+
+	// Empty if the spec can be generated, otherwise what is wrong with it
+	std::string check() const;
+};
+
+/*
+Writes a valid input file for a WorkloadSpec, in timestep order (so it can
+be streamed, see Restaurant::setStreaming). The same spec and seed always
+give the same file: the random numbers come from a Philox stream.
+
+Cancellations and promotions wait in a small heap until their timestep
+comes; the file is written through a fixed-size buffer. Memory therefore
+depends on the rate and the delays, not on the number of events.
+Complexity: O(M log P), M events, P pending cancellations / promotions
+*/
+class WorkloadGenerator
+{
+	const WorkloadSpec& spec;
+	Philox4x32 rng;
+	uint64_t draws;
+
+	std::string error;
+	int arrivals;
+	int cancellations;
+	int promotions;
+	int lastTime;
+
+	double nextUniform();
+	double nextExponential(double mean);
+
+public:
+	explicit WorkloadGenerator(const WorkloadSpec& spec);
+
+	bool write(const std::string& filename);
+
+	const std::string& getError() const { return error; }
+	int getArrivals() const { return arrivals; }
+	int getCancellations() const { return cancellations; }
+	int getPromotions() const { return promotions; }
+	int getLastTime() const { return lastTime; }
+};
+
+#endif
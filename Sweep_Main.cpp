@@ -0,0 +1,111 @@
+// Staffing optimizer: simulates every combination of the given parameter
+// ranges and prints the Pareto frontier of cost vs average wait / late orders
+// usage: restaurant_sweep <input file> [--N a:b[:step]] ... [--AutoP a:b[:step]]
+//                         [--max-late PCT] [--cook-cost X] [--speed-cost Y]
+//                         [-j threads] [--no-prune]
+//   --N --G --V --SN --SG --SV --BO --BN --BG --BV --AutoP: range of that input
+//       parameter (default: the value in the input file)
+//   --max-late: configurations with more late orders than PCT percent of the
+//       arrivals are infeasible
+//   --cook-cost / --speed-cost: cost = sum of count * (X + Y * speed) (default 1, 0)
+//   --no-prune: simulate every configuration to the end
+#include "Sim/StaffingSweep.h"
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+static void Usage(const char* program)
+{
+	std::cerr << "usage: " << program << " <input file> [--N a:b[:step]] ... [--AutoP a:b[:step]]\n"
+		<< "       [--max-late PCT] [--cook-cost X] [--speed-cost Y] [-j threads] [--no-prune]\n";
+}
+
+// "a", "a:b" or "a:b:step"
+static bool ParseRange(const char* text, ParamRange& range)
+{
+	char* end;
+	range.first = (int)strtol(text, &end, 10);
+	range.last = range.first;
+	range.step = 1;
+	if (end == text)
+		return false;
+	if (*end == ':')
+	{
+		const char* next = end + 1;
+		range.last = (int)strtol(next, &end, 10);
+		if (end == next)
+			return false;
+		if (*end == ':')
+		{
+			next = end + 1;
+			range.step = (int)strtol(next, &end, 10);
+			if (end == next)
+				return false;
+		}
+	}
+	return *end == '\0';
+}
+
+int main(int argc, char* argv[])
+{
+	std::string input;
+	int threads = 0;
+	double cookCost = 1.0, speedCost = 0.0;
+	double maxLate = -1.0;
+	bool pruning = true;
+	ParamRange ranges[PARAM_CNT];
+	bool rangeSet[PARAM_CNT] = {};
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = (i + 1 < argc);
+
+		int param = -1;
+		for (int p = 0; p < PARAM_CNT; p++)
+			if (arg == std::string("--") + StaffingSweep::ParamName((SWEEP_PARAM)p))
+				param = p;
+
+		if (param >= 0 && hasValue)
+		{
+			if (!ParseRange(argv[++i], ranges[param]))
+			{
+				std::cerr << "Bad range for " << arg << ": " << argv[i] << "\n";
+				return 1;
+			}
+			rangeSet[param] = true;
+		}
+		else if (arg == "--max-late" && hasValue) maxLate = atof(argv[++i]);
+		else if (arg == "--cook-cost" && hasValue) cookCost = atof(argv[++i]);
+		else if (arg == "--speed-cost" && hasValue) speedCost = atof(argv[++i]);
+		else if (arg == "-j" && hasValue) threads = atoi(argv[++i]);
+		else if (arg == "--no-prune") pruning = false;
+		else if (input.empty() && arg[0] != '-') input = arg;
+		else
+		{
+			Usage(argv[0]);
+			return 1;
+		}
+	}
+	if (input.empty())
+	{
+		Usage(argv[0]);
+		return 1;
+	}
+
+	StaffingSweep sweep(input, threads);
+	for (int p = 0; p < PARAM_CNT; p++)
+		if (rangeSet[p])
+			sweep.setRange((SWEEP_PARAM)p, ranges[p]);
+	sweep.setCosts(cookCost, speedCost);
+	sweep.setMaxLatePercent(maxLate);
+	sweep.setPruning(pruning);
+
+	if (!sweep.run())
+	{
+		std::cerr << "ERROR: " << sweep.getError() << "\n";
+		return 2;
+	}
+	sweep.printReport(std::cout);
+	return 0;
+}
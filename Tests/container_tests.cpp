@@ -0,0 +1,550 @@
+// Behavior checks of the containers behind the simulation (run by ctest)
+// usage: container_tests
+//
+// Each check drives a container through its tricky paths (equal keys,
+// handles reused after erase, wrap-around, aging segment changes, probe
+// chains crossing the end of the table) and compares it with a plain
+// reference: a linear scan over a small array. Prints every failed CHECK
+// and exits with 1 if there was one.
+#include "priQueue.h"
+#include "Generic_DS/HandleHeap.h"
+#include "Generic_DS/TimingWheel.h"
+#include "Rest/VIPQueue.h"
+#include "Rest/OrderIndex.h"
+#include "Rest/Order.h"
+#include <cmath>
+#include <cstdio>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			failures++; \
+			printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+		} \
+	} while (0)
+
+// Small deterministic generator (xorshift64), so failures reproduce
+static unsigned long long rngState = 88172645463325252ull;
+
+static int Random(int n)
+{
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 7;
+	rngState ^= rngState << 17;
+	return (int)(rngState % (unsigned long long)n);
+}
+
+//========================================
+// HandleHeap
+//========================================
+
+static void TestHeapTies()
+{
+	HandleHeap<int, int, 4> heap;
+	int item = -1, key = -1;
+
+	// Equal keys come out in insertion order
+	for (int i = 0; i < 10; i++)
+		heap.push(i, 7);
+	for (int i = 0; i < 10; i++)
+	{
+		CHECK(heap.pop(item, key));
+		CHECK(item == i && key == 7);
+	}
+	CHECK(heap.isEmpty());
+	CHECK(!heap.pop(item, key));
+
+	// update keeps the entry's place among equal keys
+	int a = heap.push(0, 5);
+	heap.push(1, 3);
+	heap.push(2, 3);
+	CHECK(heap.update(a, 3));
+	for (int i = 0; i < 3; i++)
+	{
+		CHECK(heap.pop(item, key));
+		CHECK(item == i && key == 3);
+	}
+
+	// erase from the middle; a handle is dead once erased or popped
+	int h[6];
+	for (int i = 0; i < 6; i++)
+		h[i] = heap.push(i, 10 - i);
+	CHECK(heap.erase(h[2]));
+	CHECK(!heap.erase(h[2]));
+	CHECK(!heap.contains(h[2]));
+	CHECK(!heap.update(h[2], 0));
+	CHECK(heap.pop(item, key) && item == 5);
+	CHECK(!heap.contains(h[5]));
+	CHECK(heap.getKey(h[0], key) && key == 10);
+	int expected[] = { 4, 3, 1, 0 };
+	for (int i = 0; i < 4; i++)
+		CHECK(heap.pop(item, key) && item == expected[i]);
+}
+
+static void TestHeapBuild()
+{
+	HandleHeap<int, int, 4> heap;
+	int item = -1, key = -1;
+
+	// Entries pushed before a build come first among equal keys
+	heap.push(100, 2);
+	heap.push(101, 1);
+
+	int items[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+	int keys[8] = { 2, 1, 2, 0, 1, 2, 0, 1 };
+	int handles[8];
+	heap.build(items, keys, 8, handles);
+	CHECK(heap.getSize() == 10);
+	for (int i = 0; i < 8; i++)
+		CHECK(heap.getKey(handles[i], key) && key == keys[i]);
+
+	// The handles of a build can be re-keyed like pushed ones
+	CHECK(heap.update(handles[7], 3));
+	CHECK(heap.erase(handles[4]));
+
+	int expected[] = { 3, 6, 101, 1, 100, 0, 2, 5, 7 };
+	for (int i = 0; i < 9; i++)
+		CHECK(heap.pop(item, key) && item == expected[i]);
+	CHECK(heap.isEmpty());
+}
+
+// Random push / build / pop / erase / update against a linear scan, with
+// few distinct keys so ties are common
+template <int Arity>
+static void TestHeapRandom()
+{
+	const int MaxLive = 200;
+	HandleHeap<int, int, Arity> heap;
+
+	int handle[MaxLive], key[MaxLive], order[MaxLive], value[MaxLive];
+	int live = 0, nextValue = 0, nextOrder = 0;
+
+	for (int step = 0; step < 20000; step++)
+	{
+		int op = Random(12);
+		if (live < MaxLive && (op < 4 || live == 0))
+		{
+			key[live] = Random(8);
+			value[live] = nextValue++;
+			order[live] = nextOrder++;
+			handle[live] = heap.push(value[live], key[live]);
+			live++;
+		}
+		else if (op >= 10)
+		{
+			int n = 1 + Random(16);
+			if (n > MaxLive - live) n = MaxLive - live;
+			for (int i = live; i < live + n; i++)
+			{
+				key[i] = Random(8);
+				value[i] = nextValue++;
+				order[i] = nextOrder++;
+			}
+			heap.build(value + live, key + live, n, handle + live);
+			live += n;
+		}
+		else if (op < 6)
+		{
+			// The reference minimum: smallest key, then oldest
+			int best = 0;
+			for (int i = 1; i < live; i++)
+				if (key[i] < key[best] || (key[i] == key[best] && order[i] < order[best]))
+					best = i;
+			int item = -1, k = -1;
+			CHECK(heap.pop(item, k));
+			CHECK(item == value[best] && k == key[best]);
+			live--;
+			handle[best] = handle[live]; key[best] = key[live];
+			order[best] = order[live]; value[best] = value[live];
+		}
+		else if (op < 8)
+		{
+			int i = Random(live);
+			CHECK(heap.erase(handle[i]));
+			CHECK(!heap.contains(handle[i]));
+			live--;
+			handle[i] = handle[live]; key[i] = key[live];
+			order[i] = order[live]; value[i] = value[live];
+		}
+		else
+		{
+			int i = Random(live);
+			key[i] = Random(8);
+			CHECK(heap.update(handle[i], key[i]));
+		}
+		CHECK(heap.getSize() == live);
+	}
+}
+
+static void TestPriQueue()
+{
+	priQueue<int> queue;
+	int item = -1;
+	double priority = 0.0;
+
+	// Highest first, equal priorities in insertion order
+	queue.enqueue(0, 1.0);
+	int h = queue.enqueue(1, 5.0);
+	queue.enqueue(2, 5.0);
+	queue.enqueue(3, 3.0);
+	CHECK(queue.update(h, 0.5));
+	CHECK(queue.getPriority(h, priority) && priority == 0.5);
+
+	int expected[] = { 2, 3, 0, 1 };
+	for (int i = 0; i < 4; i++)
+		CHECK(queue.dequeue(item, priority) && item == expected[i]);
+	CHECK(!queue.getPriority(h, priority));
+	CHECK(queue.isEmpty());
+}
+
+//========================================
+// TimingWheel
+//========================================
+
+static void TestWheelBasics()
+{
+	TimingWheel<int> wheel;
+	wheel.reset(64);
+	int fired[16];
+	int firedCount = 0;
+	auto record = [&](int item) { fired[firedCount++] = item; };
+
+	CHECK(wheel.nextFireTime() == -1);
+
+	// Same time: schedule order; different times: earliest first
+	wheel.schedule(0, 5);
+	wheel.schedule(1, 3);
+	int c = wheel.schedule(2, 5);
+	wheel.schedule(3, 5);
+	wheel.schedule(4, 9);
+	CHECK(wheel.nextFireTime() == 3);
+
+	CHECK(wheel.cancel(c));
+	CHECK(!wheel.cancel(c));
+	wheel.advanceTo(6, record);
+	CHECK(firedCount == 3);
+	CHECK(fired[0] == 1 && fired[1] == 0 && fired[2] == 3);
+	CHECK(wheel.getSize() == 1);
+	CHECK(wheel.nextFireTime() == 9);
+
+	// Moving the clock backwards or to the same time does nothing
+	wheel.advanceTo(6, record);
+	wheel.advanceTo(2, record);
+	CHECK(firedCount == 3);
+
+	// A jump of more than a revolution still fires what is due, once
+	wheel.schedule(5, 50);
+	wheel.advanceTo(1000, record);
+	CHECK(firedCount == 5);
+	CHECK(fired[3] == 4 && fired[4] == 5);
+	CHECK(wheel.isEmpty());
+	CHECK(wheel.nextFireTime() == -1);
+}
+
+static void TestWheelWrap()
+{
+	TimingWheel<int> wheel;
+	wheel.reset(64);		// 128 slots
+	int fired[8];
+	int firedCount = 0;
+	auto record = [&](int item) { fired[firedCount++] = item; };
+
+	// Fire times whose slots wrap past the end of the slot array
+	wheel.advanceTo(120, record);
+	wheel.schedule(0, 130);		// slot 2
+	wheel.schedule(1, 125);		// slot 125
+	wheel.schedule(2, 184);		// slot 56
+	CHECK(wheel.nextFireTime() == 125);
+
+	wheel.advanceTo(126, record);
+	CHECK(firedCount == 1 && fired[0] == 1);
+	CHECK(wheel.nextFireTime() == 130);
+	wheel.advanceTo(131, record);
+	CHECK(firedCount == 2 && fired[1] == 0);
+	CHECK(wheel.nextFireTime() == 184);
+
+	// Scheduled while the clock is between the two: fires first
+	int h = wheel.schedule(3, 150);
+	wheel.advanceTo(184, record);
+	CHECK(firedCount == 4 && fired[2] == 3 && fired[3] == 2);
+
+	// A timer that fired can no longer be cancelled
+	CHECK(!wheel.cancel(h));
+	CHECK(wheel.isEmpty() && wheel.nextFireTime() == -1);
+}
+
+// Random schedule / cancel / advance over many revolutions against a list
+// of pending timers
+static void TestWheelRandom()
+{
+	const int MaxLive = 300;
+	const int Horizon = 100;
+	TimingWheel<int> wheel;
+	wheel.reset(Horizon);
+
+	int handle[MaxLive], fireTime[MaxLive], value[MaxLive];
+	int live = 0, nextValue = 0, now = 0;
+	int lastFired = -1, lastTime = -1;
+	bool ok = true;
+
+	for (int step = 0; step < 20000; step++)
+	{
+		int op = Random(10);
+		if (op < 5 && live < MaxLive)
+		{
+			fireTime[live] = now + 1 + Random(Horizon);
+			value[live] = nextValue++;
+			handle[live] = wheel.schedule(value[live], fireTime[live]);
+			live++;
+		}
+		else if (op < 7 && live > 0)
+		{
+			int i = Random(live);
+			CHECK(wheel.cancel(handle[i]));
+			live--;
+			handle[i] = handle[live]; fireTime[i] = fireTime[live]; value[i] = value[live];
+		}
+		else
+		{
+			int expectedNext = -1;
+			for (int i = 0; i < live; i++)
+				if (expectedNext < 0 || fireTime[i] < expectedNext)
+					expectedNext = fireTime[i];
+			CHECK(wheel.nextFireTime() == expectedNext);
+
+			int target = now + 1 + Random(Horizon / 2);
+			lastTime = -1;
+			wheel.advanceTo(target, [&](int item) {
+				// Must be pending and due, and come out earliest first
+				int i = 0;
+				while (i < live && value[i] != item)
+					i++;
+				if (i == live || fireTime[i] > target || fireTime[i] < lastTime)
+				{
+					ok = false;
+					return;
+				}
+				lastTime = fireTime[i];
+				lastFired = item;
+				live--;
+				handle[i] = handle[live]; fireTime[i] = fireTime[live]; value[i] = value[live];
+			});
+			now = target;
+			for (int i = 0; i < live; i++)
+				CHECK(fireTime[i] > now);
+		}
+		CHECK(wheel.getSize() == live);
+	}
+	CHECK(ok);
+	CHECK(lastFired >= 0);
+}
+
+//========================================
+// VIPQueue
+//========================================
+
+// Priority gained after waiting `waited` timesteps under rule
+static double Gained(const VIPAging& rule, int waited)
+{
+	double gained = 0.0;
+	for (int k = 0; k < rule.segments; k++)
+	{
+		int from = rule.start[k];
+		int to = (k + 1 < rule.segments) ? rule.start[k + 1] : waited;
+		if (waited <= from)
+			break;
+		if (to > waited)
+			to = waited;
+		gained += rule.slope[k] * (to - from);
+	}
+	return gained;
+}
+
+static void TestVIPQueueSegments()
+{
+	VIPAging rule;
+	CHECK(VIPAging::Parse("0,10:1,20:5", rule));
+	CHECK(!VIPAging::Parse("1,5:2,5:3", rule) && !VIPAging::Parse("3:1", rule));
+	CHECK(VIPAging::Parse("0,10:1,20:5", rule));
+
+	VIPQueue queue;
+	queue.setAging(rule);
+
+	Order a(1, TYPE_VIP), b(2, TYPE_VIP);
+	a.setArrTime(0);
+	b.setArrTime(15);
+
+	queue.advanceTo(15);
+	queue.enqueue(&a, 100.0);	// waited 15: already in the middle segment
+	queue.enqueue(&b, 110.0);
+
+	Order* head;
+	double priority = 0.0;
+	CHECK(queue.peek(head, priority) && head == &b && std::fabs(priority - 110.0) < 1e-9);
+
+	// At 30, a waited 30 (0 + 10 + 5 * 10 = 60 gained), b waited 15 (5)
+	queue.advanceTo(30);
+	CHECK(queue.peek(head, priority) && head == &a && std::fabs(priority - 160.0) < 1e-9);
+	CHECK(queue.dequeue(head, priority) && head == &a);
+	CHECK(queue.dequeue(head, priority) && head == &b && std::fabs(priority - 115.0) < 1e-9);
+	CHECK(queue.isEmpty() && !queue.peek(head, priority));
+}
+
+// Random arrivals, clock jumps and dequeues against the aged priorities
+// computed from scratch
+static void TestVIPQueueRandom()
+{
+	const int MaxOrders = 400;
+	VIPAging rule;
+	CHECK(VIPAging::Parse("0.5,4:2,9:0,15:3,40:1", rule));
+
+	VIPQueue queue;
+	queue.setAging(rule);
+
+	Order* orders[MaxOrders];
+	double base[MaxOrders];
+	bool waiting[MaxOrders];
+	int created = 0, now = 0;
+
+	while (created < MaxOrders)
+	{
+		now += Random(6);
+		queue.advanceTo(now);
+
+		int arrivals = Random(4);
+		for (int i = 0; i < arrivals && created < MaxOrders; i++)
+		{
+			orders[created] = new Order(created, TYPE_VIP);
+			orders[created]->setArrTime(now);
+			base[created] = Random(1000) + created / 1000.0;	// distinct
+			waiting[created] = true;
+			queue.enqueue(orders[created], base[created]);
+			created++;
+		}
+
+		int departures = Random(3);
+		for (int d = 0; d < departures && !queue.isEmpty(); d++)
+		{
+			int best = -1;
+			double bestPriority = 0.0;
+			for (int i = 0; i < created; i++)
+			{
+				if (!waiting[i]) continue;
+				double p = base[i] + Gained(rule, now - orders[i]->GetArrTime());
+				if (best < 0 || p > bestPriority)
+				{
+					best = i;
+					bestPriority = p;
+				}
+			}
+			Order* head;
+			double priority;
+			CHECK(queue.dequeue(head, priority));
+			CHECK(head == orders[best]);
+			CHECK(std::fabs(priority - bestPriority) < 1e-6);
+			waiting[head->GetID()] = false;
+		}
+	}
+
+	int left = 0;
+	for (int i = 0; i < created; i++)
+		if (waiting[i]) left++;
+	CHECK(queue.getSize() == left);
+	for (int i = 0; i < created; i++)
+		delete orders[i];
+}
+
+//========================================
+// OrderIndex
+//========================================
+
+// Random insert / move / erase over a small ID range (long probe chains,
+// chains wrapping around the table end) against a presence array
+static void TestOrderIndexRandom()
+{
+	const int IdRange = 3000;
+	OrderIndex index;
+	Order* orders[IdRange];
+	bool present[IdRange];
+	ORD_LOCATION location[IdRange];
+	int live = 0;
+
+	for (int id = 0; id < IdRange; id++)
+	{
+		// Negative and large IDs hash like any other
+		orders[id] = new Order((id % 2) ? id * 7919 : -id, TYPE_NRM);
+		present[id] = false;
+	}
+
+	for (int step = 0; step < 60000; step++)
+	{
+		int id = Random(IdRange);
+		int op = Random(3);
+		if (op < 2)
+		{
+			ORD_LOCATION loc = (ORD_LOCATION)Random(4);
+			index.insert(orders[id], loc);
+			if (!present[id]) live++;
+			present[id] = true;
+			location[id] = loc;
+		}
+		else
+		{
+			CHECK(index.erase(orders[id]->GetID()) == present[id]);
+			if (present[id]) live--;
+			present[id] = false;
+		}
+
+		if (step % 1000 == 0)
+		{
+			for (int i = 0; i < IdRange; i++)
+			{
+				OrderIndex::Entry* e = index.find(orders[i]->GetID());
+				CHECK((e != nullptr) == present[i]);
+				if (e && present[i])
+					CHECK(e->order == orders[i] && e->location == location[i]);
+			}
+		}
+		CHECK(index.getSize() == live);
+	}
+
+	// Empty it again: every erase must leave the others reachable
+	for (int i = 0; i < IdRange; i++)
+	{
+		if (!present[i]) continue;
+		CHECK(index.erase(orders[i]->GetID()));
+		present[i] = false;
+		if (i % 97 == 0)
+			for (int j = 0; j < IdRange; j++)
+				CHECK((index.find(orders[j]->GetID()) != nullptr) == present[j]);
+	}
+	CHECK(index.getSize() == 0);
+
+	for (int id = 0; id < IdRange; id++)
+		delete orders[id];
+}
+
+int main()
+{
+	TestHeapTies();
+	TestHeapBuild();
+	TestHeapRandom<2>();
+	TestHeapRandom<4>();
+	TestPriQueue();
+	TestWheelBasics();
+	TestWheelWrap();
+	TestWheelRandom();
+	TestVIPQueueSegments();
+	TestVIPQueueRandom();
+	TestOrderIndexRandom();
+
+	if (failures > 0)
+	{
+		printf("%d check(s) failed\n", failures);
+		return 1;
+	}
+	printf("all container checks passed\n");
+	return 0;
+}
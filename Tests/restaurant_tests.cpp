@@ -0,0 +1,77 @@
+// End-to-end checks of small input files through the Restaurant (run by ctest)
+// usage: restaurant_tests
+//
+// Each case writes an input file, runs it silently, and checks the summary
+// and the output file. Prints every failed CHECK and exits with 1 if there
+// was one.
+#include "Rest/Restaurant.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			failures++; \
+			printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+		} \
+	} while (0)
+
+static bool WriteFile(const std::string& filename, const char* contents)
+{
+	std::ofstream out(filename);
+	out << contents;
+	return !out.fail();
+}
+
+// Order lines (FT ID AT WT ST) of an output file
+static int CountOrderLines(const std::string& filename)
+{
+	std::ifstream in(filename);
+	std::string line;
+	int count = 0;
+	std::getline(in, line);		// column titles
+	while (std::getline(in, line) && !line.empty())
+		count++;
+	return count;
+}
+
+// Two pairs of Normal orders sharing an ID, all auto-promoted: each must
+// leave waitNormal and be served exactly once
+static void TestDuplicateIDs()
+{
+	const char* input =
+		"1 1 1\n"
+		"1 1 1\n"
+		"3 2 2 2\n"
+		"2\n"
+		"4\n"
+		"R N 1 1 50 80\n"
+		"R N 1 1 50 80\n"
+		"R N 1 2 50 80\n"
+		"R N 1 2 5 80\n";
+	CHECK(WriteFile("dup_ids_input.txt", input));
+
+	Restaurant* pRest = new Restaurant;
+	CHECK(pRest->RunBatch("dup_ids_input.txt", "dup_ids_output.txt", MODE_SLNT));
+	SimSummary s = pRest->getSummary();
+	CHECK(s.finishedOrders == 4);
+	CHECK(s.pendingOrders == 0);
+	CHECK(CountOrderLines("dup_ids_output.txt") == 4);
+	delete pRest;
+}
+
+int main()
+{
+	TestDuplicateIDs();
+
+	if (failures > 0)
+	{
+		printf("%d check(s) failed\n", failures);
+		return 1;
+	}
+	printf("all restaurant checks passed\n");
+	return 0;
+}
@@ -0,0 +1,418 @@
+// Microbenchmarks of the containers on the simulation's hot paths
+// usage: container_bench [--min N] [--max N] [--only NAME]
+//   --min / --max: container sizes, powers of ten (default 1000 .. 10000000)
+//   --only: run only the benchmarks whose name contains NAME (e.g. "priQueue")
+//
+// Every benchmark fills a container of n pointer payloads and times one
+// operation over it, then reports per operation: wall time, calls to the
+// global operator new, and last-level cache misses (perf_event_open, Linux
+// only; "n/a" where the counter is not available, e.g. in containers that
+// forbid perf events).
+#include "LinkedList.h"
+#include "LinkedQueue.h"
+#include "priQueue.h"
+#include "Generic_DS/Queue.h"
+#include "Generic_DS/NodePool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+//========================================
+// Allocation counter: every operator new of the process goes through here
+//========================================
+
+static long long allocationCount = 0;
+
+void* operator new(size_t size)
+{
+	allocationCount++;
+	void* p = malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	allocationCount++;
+	void* p = malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+//========================================
+// Cache-miss counter of the calling thread (perf_event_open)
+//========================================
+
+class CacheMissCounter
+{
+	int fd;
+
+public:
+	CacheMissCounter() : fd(-1)
+	{
+#ifdef __linux__
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+	}
+
+	~CacheMissCounter()
+	{
+#ifdef __linux__
+		if (fd >= 0) close(fd);
+#endif
+	}
+
+	bool isAvailable() const { return fd >= 0; }
+
+	void start()
+	{
+#ifdef __linux__
+		if (fd < 0) return;
+		ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+	}
+
+	long long stop()
+	{
+		long long misses = 0;
+#ifdef __linux__
+		if (fd < 0) return 0;
+		ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+		if (read(fd, &misses, sizeof(misses)) != sizeof(misses))
+			misses = 0;
+#endif
+		return misses;
+	}
+};
+
+//========================================
+// Harness
+//========================================
+
+typedef int* Payload;       // pointer payloads, like the Order* / Cook* lists
+
+static CacheMissCounter cacheMisses;
+
+// Results of the timed loops end up here, so the compiler cannot drop them
+static volatile long long sink;
+static std::string onlyFilter;
+
+// xorshift: cheap, reproducible shuffles and priorities
+static unsigned int rngState = 2463534242u;
+static unsigned int NextRandom()
+{
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return rngState;
+}
+
+static void Shuffle(int* arr, int n)
+{
+	for (int i = n - 1; i > 0; i--)
+	{
+		int j = (int)(NextRandom() % (unsigned int)(i + 1));
+		int t = arr[i]; arr[i] = arr[j]; arr[j] = t;
+	}
+}
+
+static bool Selected(const char* name)
+{
+	return onlyFilter.empty() || strstr(name, onlyFilter.c_str()) != nullptr;
+}
+
+static void PrintHeader()
+{
+	printf("%-40s %10s %12s %10s %12s\n", "benchmark", "n", "ns/op", "allocs/op", "misses/op");
+}
+
+// Times op (ops operations) after setup, which builds the state it works on
+// Small sizes run several rounds and report the fastest, so one page fault
+// or timer tick does not dominate
+template <typename Setup, typename Op>
+static void Measure(const std::string& name, int n, long long ops, Setup setup, Op op)
+{
+	if (!Selected(name.c_str())) return;
+
+	int rounds = (n <= 100000) ? 5 : 1;
+	double bestNs = 0;
+	long long bestAllocs = 0, bestMisses = 0;
+	for (int r = 0; r < rounds; r++)
+	{
+		setup();
+
+		long long allocsBefore = allocationCount;
+		cacheMisses.start();
+		auto begin = std::chrono::steady_clock::now();
+
+		op();
+
+		auto end = std::chrono::steady_clock::now();
+		long long misses = cacheMisses.stop();
+		long long allocs = allocationCount - allocsBefore;
+
+		double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+		if (r == 0 || ns < bestNs)
+		{
+			bestNs = ns;
+			bestAllocs = allocs;
+			bestMisses = misses;
+		}
+	}
+
+	printf("%-40s %10d %12.2f %10.3f ", name.c_str(), n, bestNs / ops, (double)bestAllocs / ops);
+	if (cacheMisses.isAvailable())
+		printf("%12.3f\n", (double)bestMisses / ops);
+	else
+		printf("%12s\n", "n/a");
+	fflush(stdout);
+}
+
+//========================================
+// Benchmarks
+//========================================
+
+template <typename Alloc>
+static void BenchLinkedList(const std::string& prefix, Payload* items, int n)
+{
+	typedef LinkedList<Payload, Alloc> List;
+	List* list = nullptr;
+	auto empty = [&]() {
+		delete list;
+		list = new List;
+	};
+	auto filled = [&]() {
+		empty();
+		for (int i = 0; i < n; i++)
+			list->InsertEnd(items[i]);
+	};
+
+	Measure(prefix + " insert", n, n, empty, [&]() {
+		for (int i = 0; i < n; i++)
+			list->InsertEnd(items[i]);
+	});
+
+	Measure(prefix + " delete-first", n, n, filled, [&]() {
+		for (int i = 0; i < n; i++)
+			list->DeleteFirst();
+	});
+
+	// Random order, like cancellations and promotions out of waitNormal
+	Node<Payload>** nodes = new Node<Payload>*[n];
+	int* order = new int[n];
+	for (int i = 0; i < n; i++)
+		order[i] = i;
+	Shuffle(order, n);
+	Measure(prefix + " delete-by-pointer", n, n, [&]() {
+		empty();
+		for (int i = 0; i < n; i++)
+			nodes[i] = list->InsertEnd(items[i]);
+	}, [&]() {
+		for (int i = 0; i < n; i++)
+			list->DeleteNodeByPointer(nodes[order[i]]);
+	});
+	delete[] order;
+	delete[] nodes;
+
+	// Linear: about 10^7 nodes visited in total whatever n is
+	int searches = 10000000 / n;
+	if (searches < 1) searches = 1;
+	if (searches > 10000) searches = 10000;
+	int* targets = new int[searches];
+	for (int i = 0; i < searches; i++)
+		targets[i] = (int)(NextRandom() % (unsigned int)n);
+	Measure(prefix + " search", n, searches, filled, [&]() {
+		long long found = 0;
+		for (int i = 0; i < searches; i++)
+			found += list->search(items[targets[i]]) != nullptr;
+		sink = found;
+	});
+	delete[] targets;
+
+	delete list;
+}
+
+template <typename Alloc>
+static void BenchLinkedQueue(const std::string& prefix, Payload* items, int n)
+{
+	typedef LinkedQueue<Payload, Alloc> Fifo;
+	Fifo* queue = nullptr;
+	auto empty = [&]() {
+		delete queue;
+		queue = new Fifo;
+	};
+
+	Measure(prefix + " enqueue", n, n, empty, [&]() {
+		for (int i = 0; i < n; i++)
+			queue->enqueue(items[i]);
+	});
+
+	Measure(prefix + " dequeue", n, n, [&]() {
+		empty();
+		for (int i = 0; i < n; i++)
+			queue->enqueue(items[i]);
+	}, [&]() {
+		long long sum = 0;
+		for (int i = 0; i < n; i++)
+			sum += *queue->dequeue();
+		sink = sum;
+	});
+
+	delete queue;
+}
+
+template <typename Alloc>
+static void BenchQueue(const std::string& prefix, Payload* items, int n)
+{
+	typedef Queue<Payload, Alloc> Fifo;
+	Fifo* queue = nullptr;
+	auto empty = [&]() {
+		delete queue;
+		queue = new Fifo;
+	};
+
+	Measure(prefix + " enqueue", n, n, empty, [&]() {
+		for (int i = 0; i < n; i++)
+			queue->enqueue(items[i]);
+	});
+
+	Measure(prefix + " dequeue", n, n, [&]() {
+		empty();
+		for (int i = 0; i < n; i++)
+			queue->enqueue(items[i]);
+	}, [&]() {
+		long long sum = 0;
+		Payload p;
+		for (int i = 0; i < n; i++)
+			if (queue->dequeue(p)) sum += *p;
+		sink = sum;
+	});
+
+	delete queue;
+}
+
+template <int Arity>
+static void BenchPriQueue(const std::string& prefix, Payload* items, int n)
+{
+	typedef priQueue<Payload, double, Arity> Heap;
+	Heap* heap = nullptr;
+	auto empty = [&]() {
+		delete heap;
+		heap = new Heap;
+	};
+
+	double* priorities = new double[n];
+	for (int i = 0; i < n; i++)
+		priorities[i] = (double)(NextRandom() % 1000000) / 8.0;
+
+	Measure(prefix + " push", n, n, empty, [&]() {
+		for (int i = 0; i < n; i++)
+			heap->enqueue(items[i], priorities[i]);
+	});
+
+	Measure(prefix + " pop", n, n, [&]() {
+		empty();
+		for (int i = 0; i < n; i++)
+			heap->enqueue(items[i], priorities[i]);
+	}, [&]() {
+		long long sum = 0;
+		Payload p;
+		double priority;
+		for (int i = 0; i < n; i++)
+			if (heap->dequeue(p, priority)) sum += *p;
+		sink = sum;
+	});
+
+	Measure(prefix + " build", n, n, empty, [&]() {
+		heap->build(items, priorities, n);
+	});
+
+	delete heap;
+	delete[] priorities;
+}
+
+static void Usage(const char* program)
+{
+	fprintf(stderr, "usage: %s [--min N] [--max N] [--only NAME]\n", program);
+}
+
+int main(int argc, char* argv[])
+{
+	long long minSize = 1000;
+	long long maxSize = 10000000;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = (i + 1 < argc);
+		if (arg == "--min" && hasValue) minSize = atoll(argv[++i]);
+		else if (arg == "--max" && hasValue) maxSize = atoll(argv[++i]);
+		else if (arg == "--only" && hasValue) onlyFilter = argv[++i];
+		else
+		{
+			Usage(argv[0]);
+			return 1;
+		}
+	}
+	if (minSize < 1 || maxSize < minSize || maxSize > 100000000)
+	{
+		Usage(argv[0]);
+		return 1;
+	}
+
+	if (!cacheMisses.isAvailable())
+		printf("(cache-miss counter not available: perf_event_open failed or unsupported)\n");
+	PrintHeader();
+
+	for (long long size = minSize; size <= maxSize; size *= 10)
+	{
+		int n = (int)size;
+
+		// The payloads the pointers point to (scattered reads stay realistic:
+		// dequeue / pop dereference them)
+		int* values = new int[n];
+		Payload* items = new Payload[n];
+		for (int i = 0; i < n; i++)
+		{
+			values[i] = i;
+			items[i] = &values[i];
+		}
+
+		BenchLinkedList<HeapNodeAllocator<Payload>>("LinkedList", items, n);
+		BenchLinkedList<NodePool<Payload>>("LinkedList<NodePool>", items, n);
+		BenchLinkedQueue<HeapNodeAllocator<Payload>>("LinkedQueue", items, n);
+		BenchLinkedQueue<NodePool<Payload>>("LinkedQueue<NodePool>", items, n);
+		BenchQueue<HeapNodeAllocator<Payload>>("Queue", items, n);
+		BenchQueue<NodePool<Payload>>("Queue<NodePool>", items, n);
+		BenchPriQueue<4>("priQueue", items, n);
+		BenchPriQueue<2>("priQueue<binary>", items, n);
+
+		delete[] items;
+		delete[] values;
+	}
+	return 0;
+}
@@ -0,0 +1,221 @@
+// End-to-end throughput of the headless simulation
+// usage: sim_bench [--stream] <input file>...
+//        sim_bench [--stream] --scale A:B [--dir DIR] [--keep] [workload options]
+//   --stream: read events while simulating (see Restaurant::setStreaming)
+//   --scale: generates inputs of 10^A .. 10^B events (see Tools/workload_gen.cpp
+//            for the options; --events is set by the scale) into DIR
+//            (default: the current directory), deleted after their run
+//            unless --keep
+//
+// Every input runs silently (no report) in a fresh Restaurant. Per run:
+// events executed, timesteps simulated (idle ones are jumped over), time of
+// each phase (generate, load, simulate), events/s over load + simulate,
+// simulated timesteps/s, the peak resident set size of the run, and the
+// bytes of orders, events and list nodes still alive when it ends (see
+// AllocTracker: cooks excluded, they live as long as the restaurant). The
+// finished orders are dropped as the run goes, so that column is a leak check.
+#include "Rest/Restaurant.h"
+#include "Sim/WorkloadGenerator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#elif !defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+// Peak resident set size of the process in KB (0 if unknown)
+static long long PeakRSS()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return (long long)(counters.PeakWorkingSetSize / 1024);
+	return 0;
+#elif defined(__linux__)
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+		if (line.compare(0, 6, "VmHWM:") == 0)
+			return atoll(line.c_str() + 6);
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;		// bytes there
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
+
+// Starts a new peak at the current size, so each run reports its own
+// (Linux only: elsewhere the peak covers every run so far)
+static void ResetPeakRSS()
+{
+#ifdef __linux__
+	std::ofstream clearRefs("/proc/self/clear_refs");
+	clearRefs << "5";
+#endif
+}
+
+static double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void Usage(const char* program)
+{
+	std::cerr << "usage: " << program << " [--stream] <input file>...\n"
+		<< "       " << program << " [--stream] --scale A:B [--dir DIR] [--keep] [workload options]\n"
+		<< WorkloadSpec::OptionsHelp();
+}
+
+static void PrintHeader()
+{
+	printf("%-24s %12s %11s %11s %8s %8s %8s %12s %12s %10s %10s\n",
+		"input", "events", "timesteps", "simulated", "gen s", "load s", "sim s",
+		"events/s", "steps/s", "peak MB", "live KB");
+}
+
+// Simulates one input; false (after printing why) if it fails
+static bool Bench(const std::string& input, const std::string& label, bool streaming, double generateSeconds)
+{
+	ResetPeakRSS();
+	AllocTracker::reset();
+
+	Restaurant* pRest = new Restaurant;
+	pRest->setStreaming(streaming);
+
+	auto start = std::chrono::steady_clock::now();
+	bool ok = pRest->LoadInputFile(input);
+	double loadSeconds = SecondsSince(start);
+
+	start = std::chrono::steady_clock::now();
+	ok = ok && pRest->SimulateWithoutReport();
+	double simSeconds = SecondsSince(start);
+
+	long long peak = PeakRSS();
+	if (!ok)
+	{
+		std::cerr << "ERROR: " << input << ": " << pRest->getLastError() << "\n";
+		delete pRest;
+		return false;
+	}
+
+	SimSummary s = pRest->getSummary();
+	long long live = 0;
+	for (int t = 0; t < ALLOC_TAG_CNT; t++)
+		if (t != ALLOC_COOKS)
+			live += AllocTracker::get((ALLOC_TAG)t).liveBytes;
+	delete pRest;
+
+	double total = loadSeconds + simSeconds;
+	printf("%-24s %12lld %11d %11d %8.3f %8.3f %8.3f %12.0f %12.0f %10.1f %10.1f\n",
+		label.c_str(), s.events, s.lastTimeStep, s.simulatedSteps,
+		generateSeconds, loadSeconds, simSeconds,
+		total > 0 ? s.events / total : 0.0,
+		simSeconds > 0 ? s.simulatedSteps / simSeconds : 0.0,
+		peak / 1024.0, live / 1024.0);
+	fflush(stdout);
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	bool streaming = false;
+	bool keep = false;
+	int scaleFrom = -1, scaleTo = -1;
+	std::string dir = ".";
+	const char** inputs = new const char*[argc];
+	int inputCount = 0;
+	WorkloadSpec spec;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = (i + 1 < argc);
+		std::string name = (arg.compare(0, 2, "--") == 0) ? arg.substr(2) : std::string();
+
+		if (arg == "--stream") streaming = true;
+		else if (arg == "--keep") keep = true;
+		else if (arg == "--dir" && hasValue) dir = argv[++i];
+		else if (arg == "--scale" && hasValue)
+		{
+			if (sscanf(argv[++i], "%d:%d", &scaleFrom, &scaleTo) != 2 ||
+				scaleFrom < 0 || scaleTo < scaleFrom || scaleTo > 9)
+			{
+				std::cerr << "Bad range for --scale: " << argv[i] << "\n";
+				return 1;
+			}
+		}
+		else if (WorkloadSpec::IsOption(name) && hasValue)
+		{
+			if (!spec.setOption(name, argv[++i]))
+			{
+				std::cerr << "Bad value for " << arg << ": " << argv[i] << "\n";
+				return 1;
+			}
+		}
+		else if (arg[0] != '-') inputs[inputCount++] = argv[i];
+		else
+		{
+			Usage(argv[0]);
+			return 1;
+		}
+	}
+	if ((inputCount == 0) == (scaleFrom < 0))
+	{
+		Usage(argv[0]);
+		return 1;
+	}
+
+	PrintHeader();
+	bool allOk = true;
+
+	for (int i = 0; i < inputCount; i++)
+		allOk = Bench(inputs[i], inputs[i], streaming, 0.0) && allOk;
+	delete[] inputs;
+
+	if (scaleFrom >= 0)
+	{
+		long long events = 1;
+		for (int e = 0; e < scaleFrom; e++)
+			events *= 10;
+		for (int e = scaleFrom; e <= scaleTo; e++, events *= 10)
+		{
+			if (events > 2000000000)
+			{
+				std::cerr << "ERROR: 10^" << e << " events do not fit in an input file\n";
+				allOk = false;
+				break;
+			}
+			spec.events = (int)events;
+			std::string file = dir + "/sim_bench_1e" + std::to_string(e) + ".txt";
+
+			auto start = std::chrono::steady_clock::now();
+			WorkloadGenerator generator(spec);
+			if (!generator.write(file))
+			{
+				std::cerr << "ERROR: " << generator.getError() << "\n";
+				allOk = false;
+				break;
+			}
+			double generateSeconds = SecondsSince(start);
+
+			allOk = Bench(file, "1e" + std::to_string(e), streaming, generateSeconds) && allOk;
+			if (!keep)
+				remove(file.c_str());
+		}
+	}
+	return allOk ? 0 : 2;
+}
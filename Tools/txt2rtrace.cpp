@@ -0,0 +1,111 @@
+// Converts an input text file to the binary .rtrace format (see IO/RTrace.h)
+// usage: txt2rtrace <input file> <output .rtrace>
+//
+// Records are written in timestep order. Unsorted inputs are sorted stably,
+// so the events of one timestep keep their order from the text file, just
+// like the event calendar would run them.
+#include "IO/TraceParser.h"
+#include "IO/RTrace.h"
+#include <cstdio>
+#include <iostream>
+#include <algorithm>
+
+static bool EarlierTime(const RTraceRecord& a, const RTraceRecord& b)
+{
+	return a.time < b.time;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		std::cerr << "usage: " << argv[0] << " <input file> <output .rtrace>\n";
+		return 1;
+	}
+
+	TraceParser parser;
+	TraceHeader header;
+	if (!parser.open(argv[1]) || !parser.readHeader(header))
+	{
+		std::cerr << "ERROR: " << parser.getError() << "\n";
+		return 2;
+	}
+
+	FILE* out = fopen(argv[2], "wb");
+	if (!out)
+	{
+		std::cerr << "ERROR: cannot write to " << argv[2] << "\n";
+		return 2;
+	}
+
+	// The header is rewritten once the record count is known
+	RTraceHeader fileHeader;
+	ToRTraceHeader(header, 0, fileHeader);
+	bool ok = fwrite(&fileHeader, sizeof(fileHeader), 1, out) == 1;
+
+	static const int BatchSize = 4096;
+	RTraceRecord* batch = new RTraceRecord[BatchSize];
+	int batchCount = 0;
+	unsigned long long count = 0;
+	bool sorted = true;
+	int lastTime = 0;
+
+	EventRecord rec;
+	while (ok && parser.next(rec))
+	{
+		if (rec.time < lastTime) sorted = false;
+		lastTime = rec.time;
+
+		ToRTraceRecord(rec, batch[batchCount++]);
+		count++;
+		if (batchCount == BatchSize)
+		{
+			ok = fwrite(batch, sizeof(RTraceRecord), batchCount, out) == (size_t)batchCount;
+			batchCount = 0;
+		}
+	}
+	if (ok && batchCount > 0)
+		ok = fwrite(batch, sizeof(RTraceRecord), batchCount, out) == (size_t)batchCount;
+	delete[] batch;
+
+	if (parser.hasError())
+	{
+		fclose(out);
+		remove(argv[2]);
+		std::cerr << "ERROR: " << parser.getError() << "\n";
+		return 2;
+	}
+
+	// Rare case: read the records back and sort them in memory
+	if (ok && !sorted)
+	{
+		RTraceRecord* all = new RTraceRecord[count];
+		fflush(out);
+		FILE* in = fopen(argv[2], "rb");
+		ok = in && fseek(in, sizeof(RTraceHeader), SEEK_SET) == 0 &&
+			fread(all, sizeof(RTraceRecord), count, in) == count;
+		if (in) fclose(in);
+
+		if (ok)
+		{
+			std::stable_sort(all, all + count, EarlierTime);
+			ok = fseek(out, sizeof(RTraceHeader), SEEK_SET) == 0 &&
+				fwrite(all, sizeof(RTraceRecord), count, out) == count;
+		}
+		delete[] all;
+	}
+
+	ToRTraceHeader(header, count, fileHeader);
+	ok = ok && fseek(out, 0, SEEK_SET) == 0 && fwrite(&fileHeader, sizeof(fileHeader), 1, out) == 1;
+	ok = (fclose(out) == 0) && ok;
+
+	if (!ok)
+	{
+		remove(argv[2]);
+		std::cerr << "ERROR: cannot write to " << argv[2] << "\n";
+		return 2;
+	}
+
+	std::cout << count << " events written to " << argv[2] << (sorted ? "" : " (sorted by timestep)") << "\n";
+	return 0;
+}
@@ -0,0 +1,56 @@
+// Writes a synthetic input file (see Sim/WorkloadGenerator.h)
+// usage: workload_gen <output file> [options]
+//
+// The file is sorted by timestep, so restaurant_batch --stream can run it
+// whatever its size. Same options and seed -> same file.
+#include "Sim/WorkloadGenerator.h"
+#include <iostream>
+#include <string>
+
+static void Usage(const char* program)
+{
+	std::cerr << "usage: " << program << " <output file> [options]\n" << WorkloadSpec::OptionsHelp();
+}
+
+int main(int argc, char* argv[])
+{
+	WorkloadSpec spec;
+	std::string output;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		std::string name = (arg.compare(0, 2, "--") == 0) ? arg.substr(2) : std::string();
+
+		if (WorkloadSpec::IsOption(name) && i + 1 < argc)
+		{
+			if (!spec.setOption(name, argv[++i]))
+			{
+				std::cerr << "Bad value for " << arg << ": " << argv[i] << "\n";
+				return 1;
+			}
+		}
+		else if (output.empty() && arg[0] != '-') output = arg;
+		else
+		{
+			Usage(argv[0]);
+			return 1;
+		}
+	}
+	if (output.empty())
+	{
+		Usage(argv[0]);
+		return 1;
+	}
+
+	WorkloadGenerator generator(spec);
+	if (!generator.write(output))
+	{
+		std::cerr << "ERROR: " << generator.getError() << "\n";
+		return 2;
+	}
+	std::cout << spec.events << " events: " << generator.getArrivals() << " arrivals, "
+		<< generator.getCancellations() << " cancellations, " << generator.getPromotions()
+		<< " promotions, last timestep " << generator.getLastTime() << "\n";
+	return 0;
+}
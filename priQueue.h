@@ -1,100 +1,79 @@
 ﻿#pragma once
 #include <iostream>
+#include <stdexcept>
+#include "Generic_DS/HandleHeap.h"
 using namespace std;
 
-// Generic Priority Queue using Max Heap (Array-based)
-template <typename T>
+// Generic Priority Queue (MAX heap on a d-ary HandleHeap)
+// The highest priority comes out first; equal priorities come out in
+// insertion order. enqueue() returns a handle that stays valid until the
+// item leaves the queue, so its priority can be changed (update) or the
+// item removed (erase) without searching.
+//
+// Complexity:
+//   enqueue / dequeue / update / erase -> O(log n)
+//   build                              -> O(n)
+//   peek / getHead                     -> O(1)
+template <typename T, typename K = double, int Arity = 4>
 class priQueue
 {
-    struct Node {
-        T data;
-        int priority;
+    // Reverses the order so the MIN heap pops the largest priority
+    struct MaxKey {
+        K value;
+        bool operator<(const MaxKey& other) const { return other.value < value; }
     };
 
-    Node* array;
-    int count;
-    int capacity;
+    HandleHeap<T, MaxKey, Arity> heap;
 
-    void resize() {
-        capacity *= 2;
-        Node* newArray = new Node[capacity];
-        for (int i = 0; i < count; i++) {
-            newArray[i] = array[i];
-        }
-        delete[] array;
-        array = newArray;
-    }
+public:
+    bool isEmpty() const { return heap.isEmpty(); }
+    int getSize() const { return heap.getSize(); }
 
-    void heapifyUp(int index) {
-        if (index == 0) return;
-        int parent = (index - 1) / 2;
-        // Max Heap: Parent should be greater than child
-        if (array[index].priority > array[parent].priority) {
-            Node temp = array[index];
-            array[index] = array[parent];
-            array[parent] = temp;
-            heapifyUp(parent);
-        }
+    // Returns the handle of the new item
+    int enqueue(const T& data, const K& priority) {
+        return heap.push(data, MaxKey{ priority });
     }
 
-    void heapifyDown(int index) {
-        int left = 2 * index + 1;
-        int right = 2 * index + 2;
-        int largest = index;
-
-        if (left < count && array[left].priority > array[largest].priority)
-            largest = left;
-
-        if (right < count && array[right].priority > array[largest].priority)
-            largest = right;
-
-        if (largest != index) {
-            Node temp = array[index];
-            array[index] = array[largest];
-            array[largest] = temp;
-            heapifyDown(largest);
-        }
+    bool dequeue(T& topEntry, K& priority) {
+        MaxKey key;
+        if (!heap.pop(topEntry, key)) return false;
+        priority = key.value;
+        return true;
     }
 
-public:
-    priQueue() {
-        capacity = 20;
-        count = 0;
-        array = new Node[capacity];
+    bool peek(T& topEntry, K& priority) const {
+        MaxKey key;
+        if (!heap.peek(topEntry, key)) return false;
+        priority = key.value;
+        return true;
     }
 
-    ~priQueue() {
-        delete[] array;
+    // Changes the priority of a queued item (false if it already left)
+    bool update(int handle, const K& priority) {
+        return heap.update(handle, MaxKey{ priority });
     }
 
-    bool isEmpty() const { return count == 0; }
-    int getSize() const { return count; }
-
-    void enqueue(const T& data, int priority) {
-        if (count == capacity) resize();
-        array[count].data = data;
-        array[count].priority = priority;
-        heapifyUp(count);
-        count++;
+    // Current priority of a queued item (false if it already left)
+    bool getPriority(int handle, K& priority) const {
+        MaxKey key;
+        if (!heap.getKey(handle, key)) return false;
+        priority = key.value;
+        return true;
     }
 
-    bool dequeue(T& topEntry, int& priority) {
-        if (isEmpty()) return false;
-        topEntry = array[0].data;
-        priority = array[0].priority;
-
-        // Move last element to root
-        array[0] = array[count - 1];
-        count--;
-        heapifyDown(0);
-        return true;
+    // Removes a queued item (false if it already left)
+    bool erase(int handle) {
+        return heap.erase(handle);
     }
 
-    bool peek(T& topEntry, int& priority) const {
-        if (isEmpty()) return false;
-        topEntry = array[0].data;
-        priority = array[0].priority;
-        return true;
+    // Enqueues n items at once; handles[i] (if given) gets the handle of data[i]
+    void build(const T* data, const K* priorities, int n, int* handles = nullptr) {
+        if (n <= 0) return;
+        MaxKey* keys = new MaxKey[n];
+        for (int i = 0; i < n; i++)
+            keys[i].value = priorities[i];
+        heap.build(data, keys, n, handles);
+        delete[] keys;
     }
 
     void print() const {
@@ -103,25 +82,25 @@ public:
             return;
         }
         cout << "Priority Queue (Heap): ";
-        for (int i = 0; i < count; i++) {
-            cout << array[i].data << "(P:" << array[i].priority << ") ";
+        T data;
+        MaxKey key;
+        for (int i = 0; heap.getEntry(i, data, key); i++) {
+            cout << data << "(P:" << key.value << ") ";
         }
         cout << "\n";
     }
 
     // Helper for traversal if needed (e.g. for GUI iteration)
     bool getItem(int i, T& result) const {
-        if (i < 0 || i >= count) return false;
-        result = array[i].data;
-        return true;
+        return heap.getItem(i, result);
     }
 
     //get head
     T getHead() const {
-        if (isEmpty()) 
+        T data;
+        MaxKey key;
+        if (!heap.peek(data, key))
             throw std::out_of_range("getHead(): queue is empty");
-        return array[0].data;
-	}
-
-    //
-};
\ No newline at end of file
+        return data;
+    }
+};